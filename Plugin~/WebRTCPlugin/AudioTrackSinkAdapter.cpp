@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <algorithm>
+
 #include <audio/remix_resample.h>
 #include <common_audio/include/audio_util.h>
 
@@ -10,11 +12,27 @@ namespace unity
 namespace webrtc
 {
     AudioTrackSinkAdapter::AudioTrackSinkAdapter()
-        : _buffer(nullptr)
+        : _requestedFormat(0)
+        , _appliedFormat(0)
+        , _channels(0)
+        , _sampleRate(0)
+        , _generation(0)
+        , _request(0)
+        , _buffering(true)
+        , _targetMs(kMinTargetMs)
+        , _stableMs(0)
+        , _averageBufferedSamples(0)
+        , _driftCorrection(false)
+        , _underruns(0)
+        , _overruns(0)
+        , _droppedFrames(0)
+        , _insertedFrames(0)
+        , _bufferedMs(0)
+        , _targetMsForStats(kMinTargetMs)
     {
     }
 
-    AudioTrackSinkAdapter::~AudioTrackSinkAdapter() { WebRtc_FreeBuffer(_buffer); }
+    AudioTrackSinkAdapter::~AudioTrackSinkAdapter() { }
 
     void AudioTrackSinkAdapter::OnData(
         const void* audio_data,
@@ -23,10 +41,12 @@ namespace webrtc
         size_t number_of_channels,
         size_t number_of_frames)
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        if (_buffer == nullptr)
+        const uint64_t request = _requestedFormat.load(std::memory_order_acquire);
+        if (request == 0)
             return;
+        // Only this thread writes |_appliedFormat|.
+        if (request != _appliedFormat.load(std::memory_order_relaxed))
+            ApplyFormatRequest(request);
 
         // note: AudioTrackSinkInterface::OnData method is passed audio data from
         // audio decoder directly, so we need to resample for expected format.
@@ -46,26 +66,33 @@ namespace webrtc
 
         size_t length = _frame.num_channels() * _frame.samples_per_channel();
 
-        WebRtc_WriteBuffer(_buffer, _frame.data(), length);
+        // Samples which do not fit are dropped, so the latency stays bounded when Unity reads slowly.
+        if (_buffer.Write(_frame.data(), length) < length)
+            _overruns.fetch_add(1, std::memory_order_relaxed);
     }
 
-    void AudioTrackSinkAdapter::ResizeBuffer(size_t channels, int32_t sampleRate, size_t length)
+    uint64_t AudioTrackSinkAdapter::PackFormatRequest(uint16_t generation, size_t channels, int32_t sampleRate)
     {
+        return static_cast<uint64_t>(generation) << 48 | static_cast<uint64_t>(channels & 0xffff) << 32 |
+            static_cast<uint32_t>(sampleRate);
+    }
+
+    void AudioTrackSinkAdapter::ApplyFormatRequest(uint64_t request)
+    {
+        const size_t channels = static_cast<size_t>((request >> 32) & 0xffff);
+        const int32_t sampleRate = static_cast<int32_t>(request & 0xffffffff);
         RTC_DCHECK(channels);
         RTC_DCHECK(sampleRate);
 
-        // reallocate ring buffer, keep it relatively short at 0.2s
+        // ProcessAudio does not read the buffer until the request is applied. Keep it relatively short at 0.2s.
         size_t bufferSize = static_cast<size_t>(static_cast<float>(channels) * static_cast<float>(sampleRate) * 0.2f);
-        if (_buffer != nullptr)
-            WebRtc_FreeBuffer(_buffer);
-        _buffer = WebRtc_CreateBuffer(bufferSize, sizeof(int16_t));
+        _buffer.Reset(bufferSize);
 
         // reset audio frame.
         _frame.num_channels_ = channels;
         _frame.sample_rate_hz_ = sampleRate;
 
-        // reallocate temporary buffer.
-        _bufferIn.resize(length);
+        _appliedFormat.store(request, std::memory_order_release);
     }
 
     void AudioTrackSinkAdapter::ProcessAudio(float* data, size_t length, size_t channels, int32_t sampleRate)
@@ -75,22 +102,113 @@ namespace webrtc
         RTC_DCHECK(channels);
         RTC_DCHECK(sampleRate);
 
-        std::memset(data, 0, sizeof(float) * length);
+        // Unity changed the channel count or the sample rate. The buffer is reallocated on the WebRTC audio thread,
+        // and silence is returned until then. Every request has a new generation, so a request which is being
+        // applied is not taken for the current one.
+        if (_channels != channels || _sampleRate != sampleRate)
+        {
+            _channels = channels;
+            _sampleRate = sampleRate;
+            _request = PackFormatRequest(++_generation, channels, sampleRate);
+            _requestedFormat.store(_request, std::memory_order_release);
+            _buffering = true;
+            _stableMs = 0;
+        }
+
+        if (_appliedFormat.load(std::memory_order_acquire) != _request)
+        {
+            std::memset(data, 0, sizeof(float) * length);
+            return;
+        }
 
-        std::lock_guard<std::mutex> lock(_mutex);
+        const size_t samplesPerSecond = channels * static_cast<size_t>(sampleRate);
+        auto msToSamples = [samplesPerSecond, channels](int32_t ms)
+        { return samplesPerSecond * static_cast<size_t>(ms) / 1000 / channels * channels; };
+        size_t buffered = _buffer.size();
+        _bufferedMs.store(static_cast<int32_t>(buffered * 1000 / samplesPerSecond), std::memory_order_relaxed);
 
-        // Reallocate audio buffer when Unity changes channel count, sample rate,
-        // or data length.
-        if (_buffer == nullptr || _frame.num_channels_ != channels || _frame.sample_rate_hz_ != sampleRate ||
-            _bufferIn.size() != length)
+        // Waits for the target after an underrun, so a late packet does not cause another one right away.
+        if (_buffering)
         {
-            ResizeBuffer(channels, sampleRate, length);
+            if (buffered < msToSamples(_targetMs))
+            {
+                std::memset(data, 0, sizeof(float) * length);
+                return;
+            }
+            _buffering = false;
+            _averageBufferedSamples = static_cast<double>(buffered);
         }
+        _averageBufferedSamples += (static_cast<double>(buffered) - _averageBufferedSamples) / 16;
 
-        size_t readLength = WebRtc_ReadBuffer(_buffer, nullptr, _bufferIn.data(), length);
+        size_t readLength = 0;
+        auto consume = [data, &readLength](const int16_t* samples, size_t count)
+        {
+            webrtc::S16ToFloat(samples, count, data + readLength);
+            readLength += count;
+        };
+
+        // Audio above the target is always drained, so the latency follows the target down after an underrun raised
+        // it. Frames are only dropped or repeated one at a time, so the correction is not audible.
+        bool insertFrame = false;
+        if (length > channels)
+        {
+            const double target = static_cast<double>(msToSamples(_targetMs));
+            const double tolerance = static_cast<double>(msToSamples(kDriftToleranceMs));
+            if (_averageBufferedSamples > target + tolerance && buffered >= length + channels)
+            {
+                _buffer.Read(channels, [](const int16_t*, size_t) {});
+                _averageBufferedSamples -= channels;
+                _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            }
+            else if (_driftCorrection.load(std::memory_order_relaxed) && _averageBufferedSamples < target - tolerance)
+            {
+                insertFrame = true;
+            }
+        }
 
-        for (size_t i = 0; i < readLength; i++)
-            data[i] = webrtc::S16ToFloat(_bufferIn[i]);
+        _buffer.Read(insertFrame ? length - channels : length, consume);
+        if (insertFrame && readLength == length - channels)
+        {
+            std::memcpy(data + readLength, data + readLength - channels, sizeof(float) * channels);
+            readLength += channels;
+            _insertedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (readLength < length)
+        {
+            std::memset(data + readLength, 0, sizeof(float) * (length - readLength));
+            _underruns.fetch_add(1, std::memory_order_relaxed);
+            _buffering = true;
+            _targetMs = std::min(_targetMs + kTargetStepUpMs, kMaxTargetMs);
+            _stableMs = 0;
+        }
+        else
+        {
+            _stableMs += static_cast<int32_t>(length * 1000 / samplesPerSecond);
+            if (_stableMs >= kStablePeriodMs)
+            {
+                _targetMs = std::max(_targetMs - kTargetStepDownMs, kMinTargetMs);
+                _stableMs = 0;
+            }
+        }
+        _targetMsForStats.store(_targetMs, std::memory_order_relaxed);
+    }
+
+    void AudioTrackSinkAdapter::SetDriftCorrection(bool enabled)
+    {
+        _driftCorrection.store(enabled, std::memory_order_relaxed);
+    }
+
+    AudioTrackSinkAdapter::Stats AudioTrackSinkAdapter::GetStats() const
+    {
+        Stats stats;
+        stats.underruns = _underruns.load(std::memory_order_relaxed);
+        stats.overruns = _overruns.load(std::memory_order_relaxed);
+        stats.droppedFrames = _droppedFrames.load(std::memory_order_relaxed);
+        stats.insertedFrames = _insertedFrames.load(std::memory_order_relaxed);
+        stats.bufferedMs = _bufferedMs.load(std::memory_order_relaxed);
+        stats.targetMs = _targetMsForStats.load(std::memory_order_relaxed);
+        return stats;
     }
 } // end namespace webrtc
 } // end namespace unity
@@ -1,11 +1,12 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
 
 #include <api/audio/audio_frame.h>
 #include <api/media_stream_interface.h>
 #include <common_audio/resampler/include/push_resampler.h>
-#include <common_audio/ring_buffer.h>
+
+#include "SpscRingBuffer.h"
 
 namespace unity
 {
@@ -13,9 +14,35 @@ namespace webrtc
 {
     using namespace ::webrtc;
 
+    // Passes received audio from the WebRTC audio thread to the Unity audio thread. Neither thread locks, and the
+    // Unity audio thread does not allocate: it only requests a new format, which the WebRTC audio thread applies.
     class AudioTrackSinkAdapter : public webrtc::AudioTrackSinkInterface
     {
     public:
+        // Range of the buffered audio ProcessAudio waits for after an underrun. The target starts at the minimum,
+        // grows on each underrun and shrinks after each stable period.
+        static constexpr int32_t kMinTargetMs = 40;
+        static constexpr int32_t kMaxTargetMs = 160;
+        static constexpr int32_t kTargetStepUpMs = 20;
+        static constexpr int32_t kTargetStepDownMs = 10;
+        static constexpr int32_t kStablePeriodMs = 5000;
+        // A frame is dropped when the average buffered audio is more than this above the target. With drift
+        // correction, a frame is also repeated when it is more than this below.
+        static constexpr int32_t kDriftToleranceMs = 10;
+
+        struct Stats
+        {
+            // ProcessAudio found less audio than Unity asked for.
+            uint64_t underruns;
+            // OnData found no room for all the received audio.
+            uint64_t overruns;
+            // Frames dropped to drain the buffer toward the target, and frames repeated by the drift correction.
+            uint64_t droppedFrames;
+            uint64_t insertedFrames;
+            int32_t bufferedMs;
+            int32_t targetMs;
+        };
+
         AudioTrackSinkAdapter();
         ~AudioTrackSinkAdapter() override;
 
@@ -28,15 +55,45 @@ namespace webrtc
 
         void ProcessAudio(float* data, size_t length, size_t channels, int32_t sampleRate);
 
+        // Also repeats single frames in ProcessAudio, so the buffered audio stays near the target when the Unity
+        // audio clock runs faster than the WebRTC one. Frames above the target are dropped either way. Disabled by
+        // default.
+        void SetDriftCorrection(bool enabled);
+
+        // Can be called on any thread.
+        Stats GetStats() const;
+
     private:
-        void ResizeBuffer(size_t channels, int32_t sampleRate, size_t length);
+        static uint64_t PackFormatRequest(uint16_t generation, size_t channels, int32_t sampleRate);
+        void ApplyFormatRequest(uint64_t request);
 
+        // Used by OnData.
         AudioFrame _frame;
-        std::mutex _mutex;
-        RingBuffer* _buffer;
-        std::vector<int16_t> _bufferIn;
-
         PushResampler<int16_t> _resampler;
+
+        SpscRingBuffer<int16_t> _buffer;
+        // Format requested by ProcessAudio, and the request which OnData has applied last.
+        std::atomic<uint64_t> _requestedFormat;
+        std::atomic<uint64_t> _appliedFormat;
+
+        // Used by ProcessAudio.
+        size_t _channels;
+        int32_t _sampleRate;
+        uint16_t _generation;
+        uint64_t _request;
+        // Set until the buffered audio reaches the target.
+        bool _buffering;
+        int32_t _targetMs;
+        int32_t _stableMs;
+        double _averageBufferedSamples;
+
+        std::atomic<bool> _driftCorrection;
+        std::atomic<uint64_t> _underruns;
+        std::atomic<uint64_t> _overruns;
+        std::atomic<uint64_t> _droppedFrames;
+        std::atomic<uint64_t> _insertedFrames;
+        std::atomic<int32_t> _bufferedMs;
+        std::atomic<int32_t> _targetMsForStats;
     };
 } // end namespace webrtc
 } // end namespace unity
@@ -1,5 +1,8 @@
 #include "pch.h"
 
+#include <atomic>
+#include <cstring>
+
 #include <api/create_peerconnection_factory.h>
 #include <api/task_queue/default_task_queue_factory.h>
 #include <rtc_base/ssl_adapter.h>
@@ -30,6 +33,68 @@ namespace unity
 {
 namespace webrtc
 {
+    namespace
+    {
+        struct StatsTypeEntry
+        {
+            const char* name;
+            uint32_t id;
+        };
+
+        constexpr StatsTypeEntry kStatsTypes[] = {
+            { "codec", 0 },
+            { "inbound-rtp", 1 },
+            { "outbound-rtp", 2 },
+            { "remote-inbound-rtp", 3 },
+            { "remote-outbound-rtp", 4 },
+            { "media-source", 5 },
+            { "media-playout", 6 },
+            { "peer-connection", 7 },
+            { "data-channel", 8 },
+            { "transport", 9 },
+            { "candidate-pair", 10 },
+            { "local-candidate", 11 },
+            { "remote-candidate", 12 },
+            { "certificate", 13 },
+            // todo: If the following types are deleted from rtcstats_objects.h, delete them as well.
+            { "stream", 21 },
+            { "track", 22 }
+        };
+        constexpr size_t kStatsTypesCount = sizeof(kStatsTypes) / sizeof(kStatsTypes[0]);
+
+        // RTCStats::type() returns the kType constant of the stats class, so the pointer found for each type is
+        // compared first, and the names are only compared for a pointer which is not known yet.
+        std::atomic<const char*> s_statsTypePointers[kStatsTypesCount];
+    }
+
+    uint32_t GetStatsTypeId(const char* type)
+    {
+        for (size_t i = 0; i < kStatsTypesCount; i++)
+        {
+            if (s_statsTypePointers[i].load(std::memory_order_relaxed) == type)
+                return kStatsTypes[i].id;
+        }
+        for (size_t i = 0; i < kStatsTypesCount; i++)
+        {
+            if (std::strcmp(kStatsTypes[i].name, type) == 0)
+            {
+                s_statsTypePointers[i].store(type, std::memory_order_relaxed);
+                return kStatsTypes[i].id;
+            }
+        }
+        return kStatsTypeUnknown;
+    }
+
+    const char* GetStatsTypeName(uint32_t id)
+    {
+        for (const StatsTypeEntry& entry : kStatsTypes)
+        {
+            if (entry.id == id)
+                return entry.name;
+        }
+        return nullptr;
+    }
+
     std::unique_ptr<ContextManager> ContextManager::s_instance;
 
     ContextManager* ContextManager::GetInstance()
@@ -151,6 +216,8 @@ namespace webrtc
         : m_workerThread(rtc::Thread::CreateWithSocketServer())
         , m_signalingThread(rtc::Thread::CreateWithSocketServer())
         , m_taskQueueFactory(CreateDefaultTaskQueueFactory())
+        , m_videoRendererWorkerPool(
+              std::make_shared<VideoRendererWorkerPool>(ConversionThreadPool::DefaultThreadCount()))
     {
         m_workerThread->Start();
         m_signalingThread->Start();
@@ -283,19 +350,14 @@ namespace webrtc
     void Context::AddStatsReport(const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report)
     {
         std::lock_guard<std::mutex> lock(mutexStatsReport);
-        m_listStatsReport.push_back(report);
+        m_mapStatsReport[report.get()] = report;
     }
 
     const RTCStats** Context::GetStatsList(const RTCStatsReport* report, size_t* length, uint32_t** types)
     {
         std::lock_guard<std::mutex> lock(mutexStatsReport);
 
-        auto result = std::find_if(
-            m_listStatsReport.begin(),
-            m_listStatsReport.end(),
-            [report](rtc::scoped_refptr<const webrtc::RTCStatsReport> it) { return it.get() == report; });
-
-        if (result == m_listStatsReport.end())
+        if (m_mapStatsReport.find(report) == m_mapStatsReport.end())
         {
             RTC_LOG(LS_INFO) << "Calling GetStatsList is failed. The reference of RTCStatsReport is not found.";
             return nullptr;
@@ -314,27 +376,47 @@ namespace webrtc
         for (const auto& stats : *report)
         {
             ret[i] = &stats;
-            (*types)[i] = statsTypes.at(stats.type());
+            (*types)[i] = GetStatsTypeId(stats.type());
             i++;
         }
         return ret;
     }
 
-    void Context::DeleteStatsReport(const webrtc::RTCStatsReport* report)
+    size_t Context::SerializeStatsReport(
+        const RTCStatsReport* report,
+        const RTCStatsReport* previous,
+        const StatsReportFilter& filter,
+        uint8_t* buffer,
+        size_t capacity)
     {
         std::lock_guard<std::mutex> lock(mutexStatsReport);
 
-        auto result = std::find_if(
-            m_listStatsReport.begin(),
-            m_listStatsReport.end(),
-            [report](rtc::scoped_refptr<const webrtc::RTCStatsReport> it) { return it.get() == report; });
+        if (m_mapStatsReport.find(report) == m_mapStatsReport.end())
+        {
+            RTC_LOG(LS_INFO) << "Calling SerializeStatsReport is failed. The reference of RTCStatsReport is not found.";
+            return 0;
+        }
+        if (previous != nullptr && m_mapStatsReport.find(previous) == m_mapStatsReport.end())
+        {
+            RTC_LOG(LS_INFO) << "Calling SerializeStatsReport is failed. The reference of the previous RTCStatsReport "
+                                "is not found.";
+            return 0;
+        }
+
+        const size_t size = m_statsReportSerializer.Serialize(*report, filter, previous);
+        if (buffer != nullptr && size <= capacity)
+            m_statsReportSerializer.CopyTo(buffer);
+        return size;
+    }
+
+    void Context::DeleteStatsReport(const webrtc::RTCStatsReport* report)
+    {
+        std::lock_guard<std::mutex> lock(mutexStatsReport);
 
-        if (result == m_listStatsReport.end())
+        if (m_mapStatsReport.erase(report) == 0)
         {
             RTC_LOG(LS_INFO) << "Calling DeleteStatsReport is failed. The reference of RTCStatsReport is not found.";
-            return;
         }
-        m_listStatsReport.erase(result);
     }
 
     DataChannelInterface*
@@ -355,19 +437,29 @@ namespace webrtc
     void Context::AddDataChannel(rtc::scoped_refptr<DataChannelInterface> channel, PeerConnectionObject& pc)
     {
         auto dataChannelObj = std::make_unique<DataChannelObject>(channel, pc);
+        std::lock_guard<std::mutex> lock(m_dataChannelsMutex);
         m_mapDataChannels[channel.get()] = std::move(dataChannelObj);
     }
 
     DataChannelObject* Context::GetDataChannelObject(const DataChannelInterface* channel)
     {
-        return m_mapDataChannels[channel].get();
+        std::lock_guard<std::mutex> lock(m_dataChannelsMutex);
+        auto it = m_mapDataChannels.find(channel);
+        return it != m_mapDataChannels.end() ? it->second.get() : nullptr;
     }
 
     void Context::DeleteDataChannel(DataChannelInterface* channel)
     {
-        if (m_mapDataChannels.count(channel) > 0)
+        // Destroyed after the lock is released, because unregistering the observer waits for the signaling thread,
+        // which may be adding a channel.
+        std::unique_ptr<DataChannelObject> object;
         {
-            m_mapDataChannels.erase(channel);
+            std::lock_guard<std::mutex> lock(m_dataChannelsMutex);
+            auto it = m_mapDataChannels.find(channel);
+            if (it == m_mapDataChannels.end())
+                return;
+            object = std::move(it->second);
+            m_mapDataChannels.erase(it);
         }
     }
 
@@ -395,7 +487,8 @@ namespace webrtc
     UnityVideoRenderer* Context::CreateVideoRenderer(DelegateVideoFrameResize callback, bool needFlipVertical)
     {
         auto rendererId = GenerateRendererId();
-        auto renderer = std::make_shared<UnityVideoRenderer>(rendererId, callback, needFlipVertical);
+        auto renderer = std::make_shared<UnityVideoRenderer>(
+            rendererId, callback, needFlipVertical, m_videoRendererWorkerPool);
         m_mapVideoRenderer[rendererId] = renderer;
         return m_mapVideoRenderer[rendererId].get();
     }
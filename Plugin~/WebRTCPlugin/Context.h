@@ -6,6 +6,7 @@
 #include "DummyAudioDevice.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "PeerConnectionObject.h"
+#include "StatsReportSerializer.h"
 #include "UnityVideoRenderer.h"
 #include "UnityVideoTrackSource.h"
 
@@ -15,25 +16,14 @@ namespace webrtc
 {
     using namespace ::webrtc;
 
-    const std::map<std::string, uint32_t> statsTypes = {
-        { "codec", 0 },
-        { "inbound-rtp", 1 },
-        { "outbound-rtp", 2 },
-        { "remote-inbound-rtp", 3 },
-        { "remote-outbound-rtp", 4 },
-        { "media-source", 5 },
-        { "media-playout", 6 },
-        { "peer-connection", 7 },
-        { "data-channel", 8 },
-        { "transport", 9 },
-        { "candidate-pair", 10 },
-        { "local-candidate", 11 },
-        { "remote-candidate", 12 },
-        { "certificate", 13 },
-        // todo: If the following types are deleted from rtcstats_objects.h, delete them as well.
-        { "stream", 21 },
-        { "track", 22 }
-    };
+    // Id of a stats type which is not in the table, such as a type added by a newer libwebrtc. The managed side skips
+    // the stats of this type.
+    constexpr uint32_t kStatsTypeUnknown = 0xFFFFFFFF;
+
+    // Returns the id of RTCStats::type(), which is the value of RTCStatsType in RTCStats.cs, or kStatsTypeUnknown.
+    uint32_t GetStatsTypeId(const char* type);
+    // Returns the type of the id, or nullptr if the id is unknown.
+    const char* GetStatsTypeName(uint32_t id);
 
     class IGraphicsDevice;
     class ProfilerMarkerFactory;
@@ -126,11 +116,22 @@ namespace webrtc
         std::mutex mutexStatsReport;
         void AddStatsReport(const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report);
         const RTCStats** GetStatsList(const RTCStatsReport* report, size_t* length, uint32_t** types);
+        // Writes the stats of |report| selected by |filter| to |buffer| if it holds all of them, and returns their size
+        // in bytes, or 0 if a report is not found. Only the members changed since |previous| are written if it is not
+        // null.
+        size_t SerializeStatsReport(
+            const RTCStatsReport* report,
+            const RTCStatsReport* previous,
+            const StatsReportFilter& filter,
+            uint8_t* buffer,
+            size_t capacity);
         void DeleteStatsReport(const webrtc::RTCStatsReport* report);
 
         // DataChannel
         DataChannelInterface*
         CreateDataChannel(PeerConnectionObject* obj, const char* label, const DataChannelInit& options);
+        // AddDataChannel is called on the signaling thread for the channels opened by the remote peer, so the channels
+        // are guarded by their own lock. GetDataChannelObject returns nullptr if the channel is not found.
         void AddDataChannel(rtc::scoped_refptr<DataChannelInterface> channel, PeerConnectionObject& pc);
         DataChannelObject* GetDataChannelObject(const DataChannelInterface* channel);
         void DeleteDataChannel(DataChannelInterface* channel);
@@ -156,11 +157,15 @@ namespace webrtc
         std::unique_ptr<rtc::Thread> m_workerThread;
         std::unique_ptr<rtc::Thread> m_signalingThread;
         std::unique_ptr<TaskQueueFactory> m_taskQueueFactory;
+        // Converts the received frames of all the video renderers.
+        std::shared_ptr<VideoRendererWorkerPool> m_videoRendererWorkerPool;
         rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> m_peerConnectionFactory;
         rtc::scoped_refptr<DummyAudioDevice> m_audioDevice;
-        std::vector<rtc::scoped_refptr<const webrtc::RTCStatsReport>> m_listStatsReport;
+        std::map<const webrtc::RTCStatsReport*, rtc::scoped_refptr<const webrtc::RTCStatsReport>> m_mapStatsReport;
+        StatsReportSerializer m_statsReportSerializer;
         std::map<const PeerConnectionObject*, std::unique_ptr<PeerConnectionObject>> m_mapClients;
         std::map<const webrtc::MediaStreamInterface*, std::unique_ptr<MediaStreamObserver>> m_mapMediaStreamObserver;
+        std::mutex m_dataChannelsMutex;
         std::map<const DataChannelInterface*, std::unique_ptr<DataChannelObject>> m_mapDataChannels;
         std::map<const uint32_t, std::shared_ptr<UnityVideoRenderer>> m_mapVideoRenderer;
         std::map<const AudioTrackSinkAdapter*, std::unique_ptr<AudioTrackSinkAdapter>> m_mapAudioTrackAndSink;
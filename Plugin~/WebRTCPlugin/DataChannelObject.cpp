@@ -14,6 +14,7 @@ namespace webrtc
         , onOpen(nullptr)
         , onClose(nullptr)
         , onError(nullptr)
+        , onBufferedAmountLow(nullptr)
     {
         dataChannel->RegisterObserver(this);
     }
@@ -30,6 +31,7 @@ namespace webrtc
         onClose = nullptr;
         onOpen = nullptr;
         onMessage = nullptr;
+        onBufferedAmountLow = nullptr;
     }
 
     void DataChannelObject::OnStateChange()
@@ -67,6 +69,12 @@ namespace webrtc
     }
     void DataChannelObject::OnMessage(const webrtc::DataBuffer& buffer)
     {
+        if (IsQueuedDelivery())
+        {
+            // The buffer is shared with the message, so the data is not copied.
+            m_messages.Push(Message { buffer.data, buffer.binary });
+            return;
+        }
         if (onMessage)
         {
             size_t size = buffer.data.size();
@@ -77,5 +85,63 @@ namespace webrtc
         }
     }
 
+    void DataChannelObject::OnBufferedAmountChange(uint64_t sent_data_size)
+    {
+        if (onBufferedAmountLow == nullptr)
+            return;
+        const uint64_t threshold = GetBufferedAmountLowThreshold();
+        const uint64_t bufferedAmount = dataChannel->buffered_amount();
+        if (bufferedAmount <= threshold && bufferedAmount + sent_data_size > threshold)
+            onBufferedAmountLow(dataChannel.get(), bufferedAmount);
+    }
+
+    size_t DataChannelObject::SendBatch(const DataChannelSpan* messages, size_t count)
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (messages[i].size < 0 || (messages[i].data == nullptr && messages[i].size > 0))
+            {
+                count = i;
+                break;
+            }
+            total += static_cast<size_t>(messages[i].size);
+        }
+
+        // Each message is a slice of the same buffer, so the batch is allocated once.
+        rtc::CopyOnWriteBuffer buffer;
+        buffer.EnsureCapacity(total);
+        for (size_t i = 0; i < count; i++)
+            buffer.AppendData(messages[i].data, static_cast<size_t>(messages[i].size));
+
+        size_t offset = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const size_t size = static_cast<size_t>(messages[i].size);
+            if (!dataChannel->Send(webrtc::DataBuffer(buffer.Slice(offset, size), true)))
+                return i;
+            offset += size;
+        }
+        return count;
+    }
+
+    size_t DataChannelObject::ReceiveMessages(DataChannelMessageView* views, size_t capacity)
+    {
+        size_t count = 0;
+        Message message;
+        while (count < capacity && m_messages.Pop(&message))
+        {
+            m_heldMessages.push_back(std::move(message));
+            const Message& held = m_heldMessages.back();
+            views[count].data = held.data.cdata();
+            views[count].size = static_cast<int32_t>(held.data.size());
+            views[count].binary = held.binary ? 1 : 0;
+            count++;
+        }
+        return count;
+    }
+
+    void DataChannelObject::ReleaseMessages() { m_heldMessages.clear(); }
+
 } // end namespace webrtc
 } // end namespace unity
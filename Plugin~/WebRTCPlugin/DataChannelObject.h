@@ -1,7 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <vector>
+
 #include <api/data_channel_interface.h>
 
+#include "SpscQueue.h"
+
 namespace unity
 {
 namespace webrtc
@@ -15,6 +20,22 @@ namespace webrtc
     using DelegateOnOpen = void (*)(DataChannelInterface*);
     using DelegateOnClose = void (*)(DataChannelInterface*);
     using DelegateOnError = void (*)(DataChannelInterface*, RTCErrorType, const char*, int32_t);
+    using DelegateOnBufferedAmountLow = void (*)(DataChannelInterface*, uint64_t);
+
+    // View of a received message, passed to the managed side.
+    struct DataChannelMessageView
+    {
+        const uint8_t* data;
+        int32_t size;
+        int32_t binary;
+    };
+
+    // Message to send, passed from the managed side.
+    struct DataChannelSpan
+    {
+        const uint8_t* data;
+        int32_t size;
+    };
 
     class DataChannelObject : public DataChannelObserver
     {
@@ -27,17 +48,56 @@ namespace webrtc
         void RegisterOnOpen(DelegateOnOpen callback) { onOpen = callback; }
         void RegisterOnClose(DelegateOnClose callback) { onClose = callback; }
         void RegisterOnError(DelegateOnError callback) { onError = callback; }
+        void RegisterOnBufferedAmountLow(DelegateOnBufferedAmountLow callback) { onBufferedAmountLow = callback; }
+
+        // onBufferedAmountLow is called when the buffered amount falls from above |threshold| to |threshold| or below.
+        void SetBufferedAmountLowThreshold(uint64_t threshold)
+        {
+            m_bufferedAmountLowThreshold.store(threshold, std::memory_order_relaxed);
+        }
+        uint64_t GetBufferedAmountLowThreshold() const
+        {
+            return m_bufferedAmountLowThreshold.load(std::memory_order_relaxed);
+        }
+        // Sends |count| binary messages in order and returns the count of messages sent, which is less than |count|
+        // if the channel refuses one of them. The messages are copied into one buffer shared by all of them.
+        size_t SendBatch(const DataChannelSpan* messages, size_t count);
+
+        // In queued delivery, the received messages are kept in a queue instead of being passed to onMessage on the
+        // network thread, and the managed side takes them in batches from its own thread.
+        void SetQueuedDelivery(bool enabled) { m_queuedDelivery.store(enabled, std::memory_order_relaxed); }
+        bool IsQueuedDelivery() const { return m_queuedDelivery.load(std::memory_order_relaxed); }
+        // Takes up to |capacity| queued messages and writes a view of each of them to |views|, and returns the count.
+        // The messages are held until ReleaseMessages. Only one thread may take and release the messages.
+        size_t ReceiveMessages(DataChannelMessageView* views, size_t capacity);
+        void ReleaseMessages();
+
         // werbrtc::DataChannelObserver
         // The data channel state have changed.
         void OnStateChange() override;
         //  A data buffer was successfully received.
         void OnMessage(const webrtc::DataBuffer& buffer) override;
+        // The data channel's buffered_amount has decreased by |sent_data_size|.
+        void OnBufferedAmountChange(uint64_t sent_data_size) override;
 
         rtc::scoped_refptr<webrtc::DataChannelInterface> dataChannel;
         DelegateOnMessage onMessage;
         DelegateOnOpen onOpen;
         DelegateOnClose onClose;
         DelegateOnError onError;
+        DelegateOnBufferedAmountLow onBufferedAmountLow;
+
+    private:
+        struct Message
+        {
+            rtc::CopyOnWriteBuffer data;
+            bool binary = false;
+        };
+
+        std::atomic<bool> m_queuedDelivery { false };
+        std::atomic<uint64_t> m_bufferedAmountLowThreshold { 0 };
+        SpscQueue<Message> m_messages;
+        std::vector<Message> m_heldMessages;
     };
 
 } // end namespace webrtc
@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <limits>
+
 #include "GpuMemoryBuffer.h"
 #include "GraphicsDevice/ITexture2D.h"
 
@@ -13,19 +15,61 @@ namespace webrtc
 
     GpuMemoryBufferHandle::~GpuMemoryBufferHandle() { }
 
+    std::vector<rtc::scoped_refptr<I420BufferInterface>>
+    GpuMemoryBufferInterface::ToScaledI420(const std::vector<Size>& sizes)
+    {
+        rtc::scoped_refptr<I420BufferInterface> source = ToI420();
+        if (!source)
+            return {};
+
+        std::vector<rtc::scoped_refptr<I420BufferInterface>> buffers;
+        buffers.reserve(sizes.size());
+        for (const Size& size : sizes)
+        {
+            if (size == GetSize())
+            {
+                buffers.push_back(source);
+                continue;
+            }
+            rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(size.width(), size.height());
+            buffer->ScaleFrom(*source);
+            buffers.push_back(buffer);
+        }
+        return buffers;
+    }
+
+    CpuReadRequest::CpuReadRequest(Clock* clock)
+        : clock_(clock)
+        , lastReadUs_(std::numeric_limits<int64_t>::min())
+    {
+    }
+
+    void CpuReadRequest::Renew() { lastReadUs_.store(clock_->TimeInMicroseconds(), std::memory_order_relaxed); }
+
+    bool CpuReadRequest::IsActive() const
+    {
+        const int64_t lastReadUs = lastReadUs_.load(std::memory_order_relaxed);
+        return lastReadUs != std::numeric_limits<int64_t>::min() &&
+            clock_->TimeInMicroseconds() - lastReadUs < kTimeout.us();
+    }
+
     GpuMemoryBufferFromUnity::GpuMemoryBufferFromUnity(
-        IGraphicsDevice* device, const Size& size, UnityRenderingExtTextureFormat format)
+        IGraphicsDevice* device, const Size& size, UnityRenderingExtTextureFormat format, bool cpuReadOnDemand)
         : device_(device)
         , format_(format)
         , size_(size)
         , texture_(nullptr)
         , textureCpuRead_(nullptr)
         , handle_(nullptr)
+        , cpuReadOnDemand_(cpuReadOnDemand)
+        , cpuReadFilled_(false)
+        , cpuReadMissed_(false)
     {
         uint32_t width = static_cast<uint32_t>(size.width());
         uint32_t height = static_cast<uint32_t>(size.height());
         texture_.reset(device_->CreateDefaultTextureV(width, height, format));
-        textureCpuRead_.reset(device_->CreateCPUReadTextureV(width, height, format));
+        if (!cpuReadOnDemand_)
+            CreateCpuReadTexture();
 
 // todo(kazuki): need to refactor
 #if CUDA_PLATFORM
@@ -53,7 +97,8 @@ namespace webrtc
             RTC_LOG(LS_INFO) << "ResetSync failed.";
             return false;
         }
-        if (!device_->ResetSync(textureCpuRead_.get()))
+        std::lock_guard<std::mutex> lock(cpuReadMutex_);
+        if (textureCpuRead_ && !device_->ResetSync(textureCpuRead_.get()))
         {
             RTC_LOG(LS_INFO) << "ResetSync failed.";
             return false;
@@ -61,14 +106,45 @@ namespace webrtc
         return true;
     }
 
-    bool GpuMemoryBufferFromUnity::CopyBuffer(NativeTexPtr ptr)
+    bool GpuMemoryBufferFromUnity::CopyBuffer(NativeTexPtr ptr, std::shared_ptr<CpuReadRequest> cpuReadRequest)
     {
+        std::lock_guard<std::mutex> lock(cpuReadMutex_);
+        cpuReadFilled_ = false;
+        cpuReadRequest_ = std::move(cpuReadRequest);
+
         // One texture cannot map CUDA memory and CPU memory simultaneously.
         // Believe there is still room for improvement.
         if (!device_->CopyResourceFromNativeV(texture_.get(), ptr))
             return false;
+
+        // Skip the second copy while no consumer reads the frames of the source on the CPU.
+        if (cpuReadOnDemand_ && !cpuReadMissed_ && !(cpuReadRequest_ && cpuReadRequest_->IsActive()))
+            return true;
+        if (!textureCpuRead_ && !CreateCpuReadTexture())
+            return false;
         if (!device_->CopyResourceFromNativeV(textureCpuRead_.get(), ptr))
             return false;
+        cpuReadFilled_ = true;
+        cpuReadMissed_ = false;
+        return true;
+    }
+
+    bool GpuMemoryBufferFromUnity::HasCpuReadTexture() const
+    {
+        std::lock_guard<std::mutex> lock(cpuReadMutex_);
+        return textureCpuRead_ != nullptr;
+    }
+
+    bool GpuMemoryBufferFromUnity::CreateCpuReadTexture()
+    {
+        uint32_t width = static_cast<uint32_t>(size_.width());
+        uint32_t height = static_cast<uint32_t>(size_.height());
+        textureCpuRead_.reset(device_->CreateCPUReadTextureV(width, height, format_));
+        if (!textureCpuRead_)
+        {
+            RTC_LOG(LS_INFO) << "CreateCPUReadTextureV failed.";
+            return false;
+        }
         return true;
     }
 
@@ -78,13 +154,40 @@ namespace webrtc
 
     rtc::scoped_refptr<I420BufferInterface> GpuMemoryBufferFromUnity::ToI420()
     {
-        using namespace std::chrono_literals;
+        std::lock_guard<std::mutex> lock(cpuReadMutex_);
+        if (!PrepareCpuRead())
+            return nullptr;
+        return device_->ConvertRGBToI420(textureCpuRead_.get());
+    }
+
+    std::vector<rtc::scoped_refptr<I420BufferInterface>>
+    GpuMemoryBufferFromUnity::ToScaledI420(const std::vector<Size>& sizes)
+    {
+        std::lock_guard<std::mutex> lock(cpuReadMutex_);
+        if (!PrepareCpuRead())
+            return {};
+        std::vector<rtc::scoped_refptr<I420Buffer>> buffers =
+            device_->ConvertRGBToScaledI420(textureCpuRead_.get(), sizes);
+        return std::vector<rtc::scoped_refptr<I420BufferInterface>>(buffers.begin(), buffers.end());
+    }
+
+    bool GpuMemoryBufferFromUnity::PrepareCpuRead()
+    {
+        if (cpuReadRequest_)
+            cpuReadRequest_->Renew();
+        if (!cpuReadFilled_)
+        {
+            // GPU commands are only issued on the rendering thread, so the copy cannot be made here. This frame is
+            // dropped and the next capture fills the copy.
+            cpuReadMissed_ = true;
+            return false;
+        }
         if (!device_->WaitSync(textureCpuRead_.get()))
         {
             RTC_LOG(LS_INFO) << "WaitSync failed.";
-            return nullptr;
+            return false;
         }
-        return device_->ConvertRGBToI420(textureCpuRead_.get());
+        return true;
     }
 
     const GpuMemoryBufferHandle* GpuMemoryBufferFromUnity::handle() const
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <shared_mutex>
+#include <vector>
 
 #include <common_video/include/video_frame_buffer.h>
 #include <rtc_base/ref_counted_object.h>
+#include <system_wrappers/include/clock.h>
 
 #include "GraphicsDevice/GraphicsDevice.h"
 #include "IUnityRenderingExtensions.h"
@@ -36,36 +39,76 @@ namespace webrtc
         virtual UnityRenderingExtTextureFormat GetFormat() const = 0;
         virtual rtc::scoped_refptr<I420BufferInterface> ToI420() = 0;
 
+        // Returns an I420 buffer for each of |sizes|. Returns an empty vector on failure.
+        virtual std::vector<rtc::scoped_refptr<I420BufferInterface>> ToScaledI420(const std::vector<Size>& sizes);
+
         virtual const GpuMemoryBufferHandle* handle() const = 0;
 
     protected:
         ~GpuMemoryBufferInterface() override = default;
     };
 
+    // Made for each source of frames whose CPU readable copy is made on demand. Reading a frame of the source on the
+    // CPU renews the request, and the frames captured while it is active fill the copy on the rendering thread.
+    // The request expires when no frame has been read for kTimeout.
+    class CpuReadRequest
+    {
+    public:
+        static constexpr TimeDelta kTimeout = TimeDelta::Seconds(1);
+
+        explicit CpuReadRequest(Clock* clock);
+
+        void Renew();
+        bool IsActive() const;
+
+    private:
+        Clock* const clock_;
+        std::atomic<int64_t> lastReadUs_;
+    };
+
     class GpuMemoryBufferFromUnity : public GpuMemoryBufferInterface
     {
     public:
-        GpuMemoryBufferFromUnity(IGraphicsDevice* device, const Size& size, UnityRenderingExtTextureFormat format);
+        // The CPU readable copy is made on every capture unless |cpuReadOnDemand| is true. Otherwise it is only made
+        // by the captures which are given an active CpuReadRequest, or which follow a failed read of the buffer.
+        GpuMemoryBufferFromUnity(
+            IGraphicsDevice* device,
+            const Size& size,
+            UnityRenderingExtTextureFormat format,
+            bool cpuReadOnDemand = false);
         GpuMemoryBufferFromUnity(const GpuMemoryBufferFromUnity&) = delete;
         GpuMemoryBufferFromUnity& operator=(const GpuMemoryBufferFromUnity&) = delete;
 
         bool ResetSync();
-        bool CopyBuffer(NativeTexPtr ptr);
+        // Must be called on the rendering thread. |cpuReadRequest| belongs to the source of the captured image.
+        bool CopyBuffer(NativeTexPtr ptr, std::shared_ptr<CpuReadRequest> cpuReadRequest = nullptr);
+        bool HasCpuReadTexture() const;
         UnityRenderingExtTextureFormat GetFormat() const override;
         Size GetSize() const override;
         rtc::scoped_refptr<I420BufferInterface> ToI420() override;
+        std::vector<rtc::scoped_refptr<I420BufferInterface>> ToScaledI420(const std::vector<Size>& sizes) override;
         const GpuMemoryBufferHandle* handle() const override;
 
     protected:
         ~GpuMemoryBufferFromUnity() override;
 
     private:
+        bool PrepareCpuRead();
+        bool CreateCpuReadTexture();
+
         IGraphicsDevice* device_;
         UnityRenderingExtTextureFormat format_;
         Size size_;
         std::unique_ptr<ITexture2D> texture_;
         std::unique_ptr<ITexture2D> textureCpuRead_;
         std::unique_ptr<GpuMemoryBufferHandle> handle_;
+        const bool cpuReadOnDemand_;
+        std::shared_ptr<CpuReadRequest> cpuReadRequest_;
+        // Whether textureCpuRead_ holds the last captured image.
+        bool cpuReadFilled_;
+        // Set when the buffer is read before the copy is made, so that the next capture makes it.
+        bool cpuReadMissed_;
+        mutable std::mutex cpuReadMutex_;
     };
 }
 }
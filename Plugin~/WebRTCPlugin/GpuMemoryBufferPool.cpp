@@ -12,6 +12,10 @@ namespace webrtc
 {
     GpuMemoryBufferPool::GpuMemoryBufferPool(IGraphicsDevice* device, Clock* clock)
         : device_(device)
+        , budget_(kDefaultBudget)
+        , cpuReadback_(CpuReadback::Always)
+        , textureBytes_(0)
+        , cpuReadBytes_(0)
         , clock_(clock)
     {
     }
@@ -19,100 +23,270 @@ namespace webrtc
     GpuMemoryBufferPool::~GpuMemoryBufferPool() { }
 
     rtc::scoped_refptr<VideoFrame> GpuMemoryBufferPool::CreateFrame(
-        NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format, Timestamp timestamp)
+        NativeTexPtr ptr,
+        const Size& size,
+        UnityRenderingExtTextureFormat format,
+        Timestamp timestamp,
+        const void* source)
     {
-        auto buffer = GetOrCreateFrameResources(ptr, size, format);
-        if (!buffer)
+        FrameResources* resources = GetOrCreateFrameResources(ptr, size, format, source);
+        if (!resources)
             return nullptr;
+
+        // The resources are carried in the callback so that returning the buffer does not need to search the pool.
         VideoFrame::ReturnBufferToPoolCallback callback =
-            std::bind(&GpuMemoryBufferPool::OnReturnBuffer, this, std::placeholders::_1);
+            std::bind(&GpuMemoryBufferPool::OnReturnBuffer, this, resources, std::placeholders::_1);
 
         return VideoFrame::WrapExternalGpuMemoryBuffer(
-            size, buffer, callback, webrtc::TimeDelta::Micros(timestamp.us()));
+            size, resources->buffer_, callback, webrtc::TimeDelta::Micros(timestamp.us()));
     }
 
-    rtc::scoped_refptr<GpuMemoryBufferInterface> GpuMemoryBufferPool::GetOrCreateFrameResources(
-        NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format)
+    GpuMemoryBufferPool::FrameResources* GpuMemoryBufferPool::GetOrCreateFrameResources(
+        NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format, const void* source)
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        for (auto it = resourcesPool_.begin(); it != resourcesPool_.end(); ++it)
+        if (source && budget_.maxInFlightFramesPerSource > 0)
+        {
+            auto it = inFlightFrames_.find(source);
+            if (it != inFlightFrames_.end() && it->second >= budget_.maxInFlightFramesPerSource)
+                return nullptr;
+        }
+
+        const FrameResourcesKey key { size, format };
+        std::shared_ptr<CpuReadRequest> cpuReadRequest = GetCpuReadRequest(source);
+        auto found = freeLists_.find(key);
+        if (found != freeLists_.end())
         {
-            FrameResources* resources = it->get();
-            if (!resources->IsUsed() && AreFrameResourcesCompatible(resources, size, format))
+            // Try the most recently returned resources first.
+            FreeList& freeList = found->second;
+            for (auto it = freeList.rbegin(); it != freeList.rend(); ++it)
             {
+                FrameResources* resources = *it;
                 GpuMemoryBufferFromUnity* buffer = static_cast<GpuMemoryBufferFromUnity*>(resources->buffer_.get());
                 if (!buffer->ResetSync())
                 {
                     RTC_LOG(LS_INFO) << "It has not signaled yet";
                     continue;
                 }
-                if (!buffer->CopyBuffer(ptr))
+                if (!buffer->CopyBuffer(ptr, cpuReadRequest))
                 {
                     RTC_LOG(LS_INFO) << "Copy buffer is failed.";
                     continue;
                 }
-                resources->MarkUsed(clock_->CurrentTime());
-                return resources->buffer_;
+                freeList.erase(std::next(it).base());
+                UpdateCpuReadBytes(resources);
+                MarkUsed(resources, source);
+                return resources;
             }
         }
-        rtc::scoped_refptr<GpuMemoryBufferFromUnity> buffer =
-            rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, size, format);
-        if (!buffer->CopyBuffer(ptr))
+
+        if (!ReserveBytes(EstimateBufferBytesLocked(size, source), key))
+            return nullptr;
+
+        rtc::scoped_refptr<GpuMemoryBufferFromUnity> buffer = rtc::make_ref_counted<GpuMemoryBufferFromUnity>(
+            device_, size, format, cpuReadback_ == CpuReadback::OnDemand);
+        if (!buffer->CopyBuffer(ptr, cpuReadRequest))
         {
             RTC_LOG(LS_INFO) << "Copy buffer is failed.";
             return nullptr;
         }
-        std::unique_ptr<FrameResources> resources = std::make_unique<FrameResources>(buffer);
+        const size_t textureBytes = EstimateTextureBytes(size);
+        std::unique_ptr<FrameResources> resources = std::make_unique<FrameResources>(buffer, textureBytes);
+        FrameResources* result = resources.get();
+        result->position_ = resourcesPool_.insert(resourcesPool_.end(), std::move(resources));
+        textureBytes_ += textureBytes;
+        UpdateCpuReadBytes(result);
+        MarkUsed(result, source);
+        return result;
+    }
+
+    std::shared_ptr<CpuReadRequest> GpuMemoryBufferPool::GetCpuReadRequest(const void* source)
+    {
+        if (cpuReadback_ != CpuReadback::OnDemand)
+            return nullptr;
+        std::shared_ptr<CpuReadRequest>& request = cpuReadRequests_[source];
+        if (!request)
+            request = std::make_shared<CpuReadRequest>(clock_);
+        return request;
+    }
+
+    void GpuMemoryBufferPool::MarkUsed(FrameResources* resources, const void* source)
+    {
         resources->MarkUsed(clock_->CurrentTime());
-        resourcesPool_.push_back(std::move(resources));
-        return std::move(buffer);
+        resources->source_ = source;
+        if (source)
+            inFlightFrames_[source]++;
+    }
+
+    void GpuMemoryBufferPool::UpdateCpuReadBytes(FrameResources* resources)
+    {
+        // The CPU readable copy may be allocated later on the thread which reads the frame.
+        if (resources->cpuReadBytes_ > 0)
+            return;
+        GpuMemoryBufferFromUnity* buffer = static_cast<GpuMemoryBufferFromUnity*>(resources->buffer_.get());
+        if (!buffer->HasCpuReadTexture())
+            return;
+        resources->cpuReadBytes_ = resources->textureBytes_;
+        cpuReadBytes_ += resources->cpuReadBytes_;
+    }
+
+    bool GpuMemoryBufferPool::ReserveBytes(size_t bytes, const FrameResourcesKey& key)
+    {
+        if (budget_.maxBytes == 0)
+            return true;
+
+        while (textureBytes_ + cpuReadBytes_ + bytes > budget_.maxBytes)
+        {
+            // Pick the oldest unused resources among the other resolutions.
+            FreeList* oldest = nullptr;
+            for (auto& pair : freeLists_)
+            {
+                if (pair.first == key || pair.second.empty())
+                    continue;
+                if (!oldest || pair.second.front()->lastUseTime() < oldest->front()->lastUseTime())
+                    oldest = &pair.second;
+            }
+
+            // Unused resources of the same resolution are never released here. They were not reused because they
+            // have not signaled yet, and the GPU may still be writing to them. The frame is dropped instead.
+            if (!oldest)
+                return false;
+            EraseOldestFreeResources(*oldest);
+        }
+        return true;
     }
 
-    bool GpuMemoryBufferPool::AreFrameResourcesCompatible(
-        const FrameResources* resources, const Size& size, UnityRenderingExtTextureFormat format)
+    void GpuMemoryBufferPool::EraseOldestFreeResources(FreeList& freeList)
     {
-        return resources->buffer_->GetSize() == size && resources->buffer_->GetFormat() == format;
+        FrameResources* resources = freeList.front();
+        freeList.pop_front();
+        textureBytes_ -= resources->textureBytes_;
+        cpuReadBytes_ -= resources->cpuReadBytes_;
+        resourcesPool_.erase(resources->position_);
     }
 
-    void GpuMemoryBufferPool::OnReturnBuffer(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer)
+    void GpuMemoryBufferPool::OnReturnBuffer(
+        FrameResources* resources, rtc::scoped_refptr<GpuMemoryBufferInterface> buffer)
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        GpuMemoryBufferInterface* ptr = buffer.get();
-        if (!ptr)
+        if (!buffer)
         {
             RTC_LOG(LS_INFO) << "buffer is nullptr.";
             return;
         }
+        RTC_DCHECK_EQ(resources->buffer_.get(), buffer.get());
 
-        auto result =
-            std::find_if(resourcesPool_.begin(), resourcesPool_.end(), [ptr](std::unique_ptr<FrameResources>& x) {
-                return x->buffer_.get() == ptr;
-            });
-        RTC_DCHECK(result != resourcesPool_.end());
-
-        (*result)->MarkUnused(clock_->CurrentTime());
+        if (resources->source_)
+        {
+            auto it = inFlightFrames_.find(resources->source_);
+            RTC_DCHECK(it != inFlightFrames_.end());
+            if (it != inFlightFrames_.end() && --it->second == 0)
+                inFlightFrames_.erase(it);
+            resources->source_ = nullptr;
+        }
+        UpdateCpuReadBytes(resources);
+        resources->MarkUnused(clock_->CurrentTime());
+        freeLists_[FrameResourcesKey { buffer->GetSize(), buffer->GetFormat() }].push_back(resources);
     }
 
     void GpuMemoryBufferPool::ReleaseStaleBuffers(Timestamp now, TimeDelta timeLimit)
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        auto it = resourcesPool_.begin();
-        for (; it != resourcesPool_.end();)
+        // Each free list is ordered by the returned time, so only the front needs to be checked.
+        for (auto it = freeLists_.begin(); it != freeLists_.end();)
         {
-            FrameResources* resources = (*it).get();
+            FreeList& freeList = it->second;
+            while (!freeList.empty() && now - freeList.front()->lastUseTime() > timeLimit)
+                EraseOldestFreeResources(freeList);
 
-            if (!resources->IsUsed() && now - resources->lastUseTime() > timeLimit)
-            {
-                it = resourcesPool_.erase(it);
-            }
+            if (freeList.empty())
+                it = freeLists_.erase(it);
             else
-            {
                 ++it;
-            }
         }
+
+        for (auto it = cpuReadRequests_.begin(); it != cpuReadRequests_.end();)
+        {
+            if (!it->second->IsActive() && inFlightFrames_.find(it->first) == inFlightFrames_.end())
+                it = cpuReadRequests_.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void GpuMemoryBufferPool::SetBudget(const Budget& budget)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = budget;
+    }
+
+    GpuMemoryBufferPool::Budget GpuMemoryBufferPool::budget()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return budget_;
+    }
+
+    void GpuMemoryBufferPool::SetCpuReadback(CpuReadback mode)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cpuReadback_ = mode;
+    }
+
+    GpuMemoryBufferPool::CpuReadback GpuMemoryBufferPool::cpuReadback()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cpuReadback_;
+    }
+
+    size_t GpuMemoryBufferPool::bufferCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return resourcesPool_.size();
+    }
+
+    size_t GpuMemoryBufferPool::totalBytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return textureBytes_ + cpuReadBytes_;
+    }
+
+    size_t GpuMemoryBufferPool::cpuReadBytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cpuReadBytes_;
+    }
+
+    uint32_t GpuMemoryBufferPool::inFlightFrames(const void* source)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = inFlightFrames_.find(source);
+        return it != inFlightFrames_.end() ? it->second : 0;
+    }
+
+    size_t GpuMemoryBufferPool::EstimateBufferBytes(const Size& size, const void* source)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return EstimateBufferBytesLocked(size, source);
+    }
+
+    size_t GpuMemoryBufferPool::EstimateBufferBytesLocked(const Size& size, const void* source) const
+    {
+        bool cpuRead = cpuReadback_ == CpuReadback::Always;
+        if (!cpuRead)
+        {
+            auto it = cpuReadRequests_.find(source);
+            cpuRead = it != cpuReadRequests_.end() && it->second->IsActive();
+        }
+        return EstimateTextureBytes(size) * (cpuRead ? 2 : 1);
+    }
+
+    size_t GpuMemoryBufferPool::EstimateTextureBytes(const Size& size)
+    {
+        const size_t kBytesPerPixel = 4;
+        return static_cast<size_t>(size.width()) * static_cast<size_t>(size.height()) * kBytesPerPixel;
     }
 }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <deque>
 #include <list>
+#include <unordered_map>
 #include <system_wrappers/include/clock.h>
 
 #include "GpuMemoryBuffer.h"
@@ -14,24 +16,73 @@ namespace webrtc
     class GpuMemoryBufferPool
     {
     public:
+        // Limits applied when creating frames. Zero means no limit.
+        struct Budget
+        {
+            // Total size of all pooled buffers, used and unused.
+            size_t maxBytes;
+            // Number of frames which one source can hold at the same time.
+            uint32_t maxInFlightFramesPerSource;
+        };
+
+        // About twenty 1080p buffers, with their CPU readable copies.
+        static constexpr Budget kDefaultBudget = { 20 * 1920 * 1080 * 4 * 2, 8 };
+
+        // When the CPU readable copies of the buffers are made.
+        enum class CpuReadback
+        {
+            // Filled on every capture together with the texture.
+            Always,
+            // Allocated and filled only while a consumer, e.g. a software encoder, reads the frames of the same source
+            // on the CPU.
+            OnDemand,
+        };
+
         GpuMemoryBufferPool(IGraphicsDevice* device, Clock* clock);
         GpuMemoryBufferPool(const GpuMemoryBufferPool&) = delete;
         GpuMemoryBufferPool& operator=(const GpuMemoryBufferPool&) = delete;
 
         virtual ~GpuMemoryBufferPool();
 
-        rtc::scoped_refptr<VideoFrame>
-        CreateFrame(NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format, Timestamp timestamp);
+        // Returns nullptr when the frame is dropped. |source| identifies the owner of the frame for the per-source
+        // limit. Frames without a source are not counted.
+        rtc::scoped_refptr<VideoFrame> CreateFrame(
+            NativeTexPtr ptr,
+            const Size& size,
+            UnityRenderingExtTextureFormat format,
+            Timestamp timestamp,
+            const void* source = nullptr);
         void ReleaseStaleBuffers(Timestamp timestamp, TimeDelta timeLimit);
 
-        size_t bufferCount() { return resourcesPool_.size(); }
+        void SetBudget(const Budget& budget);
+        Budget budget();
+
+        // Applied to the buffers created after the call.
+        void SetCpuReadback(CpuReadback mode);
+        CpuReadback cpuReadback();
+
+        size_t bufferCount();
+        size_t totalBytes();
+        size_t cpuReadBytes();
+        uint32_t inFlightFrames(const void* source);
+
+        // Memory reserved for a new buffer of |source|, including the CPU readable copy if it is made when capturing.
+        size_t EstimateBufferBytes(const Size& size, const void* source = nullptr);
+        static size_t EstimateTextureBytes(const Size& size);
 
     private:
+        struct FrameResources;
+        using ResourcesList = std::list<std::unique_ptr<FrameResources>>;
+
         struct FrameResources
         {
-            FrameResources(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer)
+            FrameResources(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer, size_t textureBytes)
                 : buffer_(std::move(buffer))
+                , isUsed_(false)
                 , lastUsetime_(Timestamp::Zero())
+                , textureBytes_(textureBytes)
+                , cpuReadBytes_(0)
+                , source_(nullptr)
             {
             }
             rtc::scoped_refptr<GpuMemoryBufferInterface> buffer_;
@@ -49,17 +100,64 @@ namespace webrtc
             Timestamp lastUseTime() { return lastUsetime_; }
             bool isUsed_;
             Timestamp lastUsetime_;
+            size_t textureBytes_;
+            // Zero until the CPU readable copy is allocated.
+            size_t cpuReadBytes_;
+            // Owner of the frame while the resources are used.
+            const void* source_;
+            // Position in resourcesPool_ to erase this entry without searching.
+            ResourcesList::iterator position_;
+        };
+
+        struct FrameResourcesKey
+        {
+            Size size;
+            UnityRenderingExtTextureFormat format;
+
+            bool operator==(const FrameResourcesKey& other) const
+            {
+                return size == other.size && format == other.format;
+            }
+        };
+
+        struct FrameResourcesKeyHash
+        {
+            size_t operator()(const FrameResourcesKey& key) const
+            {
+                size_t hash = std::hash<int>()(key.size.width());
+                hash = hash * 31 + std::hash<int>()(key.size.height());
+                hash = hash * 31 + std::hash<int>()(static_cast<int>(key.format));
+                return hash;
+            }
         };
-        rtc::scoped_refptr<GpuMemoryBufferInterface>
-        GetOrCreateFrameResources(NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format);
-        void OnReturnBuffer(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer);
 
-        static bool AreFrameResourcesCompatible(
-            const FrameResources* resources, const Size& size, UnityRenderingExtTextureFormat format);
+        // Unused resources ordered by the time they were returned. The newest one is at the back.
+        using FreeList = std::deque<FrameResources*>;
+
+        FrameResources* GetOrCreateFrameResources(
+            NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format, const void* source);
+        void OnReturnBuffer(FrameResources* resources, rtc::scoped_refptr<GpuMemoryBufferInterface> buffer);
+        void MarkUsed(FrameResources* resources, const void* source);
+        void UpdateCpuReadBytes(FrameResources* resources);
+        size_t EstimateBufferBytesLocked(const Size& size, const void* source) const;
+        std::shared_ptr<CpuReadRequest> GetCpuReadRequest(const void* source);
+
+        // Releases unused buffers of other resolutions until |bytes| fits in the budget, starting from the oldest one.
+        // Returns false if they are not enough.
+        bool ReserveBytes(size_t bytes, const FrameResourcesKey& key);
+        void EraseOldestFreeResources(FreeList& freeList);
 
         IGraphicsDevice* device_;
         std::mutex mutex_;
-        std::list<std::unique_ptr<FrameResources>> resourcesPool_;
+        ResourcesList resourcesPool_;
+        std::unordered_map<FrameResourcesKey, FreeList, FrameResourcesKeyHash> freeLists_;
+        std::unordered_map<const void*, uint32_t> inFlightFrames_;
+        Budget budget_;
+        CpuReadback cpuReadback_;
+        // Requests of the sources in OnDemand mode. Expired requests are erased with the stale buffers.
+        std::unordered_map<const void*, std::shared_ptr<CpuReadRequest>> cpuReadRequests_;
+        size_t textureBytes_;
+        size_t cpuReadBytes_;
         Clock* const clock_;
     };
 }
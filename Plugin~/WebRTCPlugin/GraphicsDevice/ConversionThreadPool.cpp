@@ -0,0 +1,109 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "ConversionThreadPool.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    ConversionThreadPool::ConversionThreadPool(size_t threadCount)
+        : m_threadCount(1)
+        , m_quit(false)
+    {
+        SetThreadCount(threadCount);
+    }
+
+    ConversionThreadPool::~ConversionThreadPool() { SetThreadCount(1); }
+
+    size_t ConversionThreadPool::DefaultThreadCount()
+    {
+        const size_t hardwareThreads = std::thread::hardware_concurrency();
+        return std::clamp<size_t>(hardwareThreads / 2, 1, 4);
+    }
+
+    void ConversionThreadPool::SetThreadCount(size_t threadCount)
+    {
+        threadCount = std::clamp<size_t>(threadCount, 1, kMaxThreadCount);
+
+        std::lock_guard<std::mutex> config(m_configMutex);
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (threadCount == m_threadCount)
+                return;
+            m_quit = true;
+            threads.swap(m_threads);
+        }
+        m_condition.notify_all();
+
+        // Workers finish the batch they are running before quitting.
+        for (auto& thread : threads)
+            thread.join();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = false;
+        m_threadCount = threadCount;
+        for (size_t i = 1; i < threadCount; i++)
+            m_threads.emplace_back(&ConversionThreadPool::Run, this);
+    }
+
+    size_t ConversionThreadPool::threadCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_threadCount;
+    }
+
+    void ConversionThreadPool::ParallelFor(size_t count, const std::function<void(size_t index)>& task)
+    {
+        if (count == 0)
+            return;
+
+        Batch batch { &task, count, { 0 }, 0 };
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const size_t helpers = std::min(m_threads.size(), count - 1);
+            for (size_t i = 0; i < helpers; i++)
+                m_queue.push_back(&batch);
+        }
+        m_condition.notify_all();
+
+        RunBatch(&batch);
+
+        // All indices are taken. Drop the entries no worker has picked up and wait for the running ones.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), &batch), m_queue.end());
+        m_finished.wait(lock, [&batch] { return batch.workers == 0; });
+    }
+
+    void ConversionThreadPool::Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_condition.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+            if (m_quit)
+                return;
+
+            Batch* batch = m_queue.front();
+            m_queue.pop_front();
+            batch->workers++;
+
+            lock.unlock();
+            RunBatch(batch);
+            lock.lock();
+
+            if (--batch->workers == 0)
+                m_finished.notify_all();
+        }
+    }
+
+    void ConversionThreadPool::RunBatch(Batch* batch)
+    {
+        for (size_t index = batch->next++; index < batch->count; index = batch->next++)
+            (*batch->task)(index);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
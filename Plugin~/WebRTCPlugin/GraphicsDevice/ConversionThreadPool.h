@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Small set of worker threads which split a pixel conversion into bands. The calling thread processes bands too,
+    // so a pool with one thread has no workers and runs everything on the caller.
+    // This class is thread safe.
+    class ConversionThreadPool
+    {
+    public:
+        static constexpr size_t kMaxThreadCount = 16;
+
+        explicit ConversionThreadPool(size_t threadCount = DefaultThreadCount());
+        ConversionThreadPool(const ConversionThreadPool&) = delete;
+        ConversionThreadPool& operator=(const ConversionThreadPool&) = delete;
+        ~ConversionThreadPool();
+
+        // Half of the hardware threads, up to four, because the encoders run on the other ones.
+        static size_t DefaultThreadCount();
+
+        // The number of threads including the calling thread. Clamped to [1, kMaxThreadCount].
+        void SetThreadCount(size_t threadCount);
+        size_t threadCount();
+
+        // Calls |task| with each index in [0, count) and returns after all calls finish.
+        void ParallelFor(size_t count, const std::function<void(size_t index)>& task);
+
+    private:
+        struct Batch
+        {
+            const std::function<void(size_t)>* task;
+            size_t count;
+            std::atomic<size_t> next;
+            // The number of workers running this batch. Guarded by m_mutex.
+            size_t workers;
+        };
+
+        void Run();
+        static void RunBatch(Batch* batch);
+
+        std::mutex m_configMutex;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_finished;
+        std::deque<Batch*> m_queue;
+        std::vector<std::thread> m_threads;
+        size_t m_threadCount;
+        bool m_quit;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
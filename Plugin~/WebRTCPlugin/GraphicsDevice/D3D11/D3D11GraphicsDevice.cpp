@@ -1,6 +1,6 @@
 #include "pch.h"
 
-#include <third_party/libyuv/include/libyuv/convert.h>
+#include <third_party/libyuv/include/libyuv/video_common.h>
 
 #include "D3D11GraphicsDevice.h"
 #include "D3D11Texture2D.h"
@@ -175,39 +175,28 @@ namespace webrtc
 
     //---------------------------------------------------------------------------------------------------------------------
 
-    rtc::scoped_refptr<I420Buffer> D3D11GraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    bool D3D11GraphicsDevice::ReadPixels(ITexture2D* tex, const ReadPixelsCallback& callback)
     {
         D3D11_MAPPED_SUBRESOURCE pMappedResource;
 
         ID3D11Resource* pResource = reinterpret_cast<ID3D11Resource*>(tex->GetNativeTexturePtrV());
         if (nullptr == pResource)
-            return nullptr;
+            return false;
 
         ComPtr<ID3D11DeviceContext> context;
         m_d3d11Device->GetImmediateContext(context.GetAddressOf());
 
         const HRESULT hr = context->Map(pResource, 0, D3D11_MAP_READ, 0, &pMappedResource);
         if (hr != S_OK)
-            return nullptr;
-
-        const int32_t width = static_cast<int32_t>(tex->GetWidth());
-        const int32_t height = static_cast<int32_t>(tex->GetHeight());
+            return false;
 
-        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer = webrtc::I420Buffer::Create(width, height);
-        libyuv::ARGBToI420(
+        callback(
             static_cast<uint8_t*>(pMappedResource.pData),
             static_cast<int32_t>(pMappedResource.RowPitch),
-            i420_buffer->MutableDataY(),
-            i420_buffer->StrideY(),
-            i420_buffer->MutableDataU(),
-            i420_buffer->StrideU(),
-            i420_buffer->MutableDataV(),
-            i420_buffer->StrideV(),
-            width,
-            height);
+            libyuv::FOURCC_ARGB);
 
         context->Unmap(pResource, 0);
-        return i420_buffer;
+        return true;
     }
 
     std::unique_ptr<GpuMemoryBufferHandle> D3D11GraphicsDevice::Map(ITexture2D* texture)
@@ -36,7 +36,7 @@ namespace webrtc
         void Enter() override;
         void Leave() override;
 
-        virtual rtc::scoped_refptr<::webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) override;
+        virtual bool ReadPixels(ITexture2D* tex, const ReadPixelsCallback& callback) override;
         bool IsCudaSupport() override { return m_isCudaSupport; }
         CUcontext GetCUcontext() override { return m_cudaContext.GetContext(); }
         NV_ENC_BUFFER_FORMAT GetEncodeBufferFormat() override { return NV_ENC_BUFFER_FORMAT_ARGB; }
@@ -334,22 +334,20 @@ namespace webrtc
     }
 
     //----------------------------------------------------------------------------------------------------------------------
-    rtc::scoped_refptr<webrtc::I420Buffer> D3D12GraphicsDevice::ConvertRGBToI420(ITexture2D* texture)
+    bool D3D12GraphicsDevice::ReadPixels(ITexture2D* texture, const ReadPixelsCallback& callback)
     {
         D3D12Texture2D* d3dTexture2d = reinterpret_cast<D3D12Texture2D*>(texture);
         if (!d3dTexture2d)
         {
             RTC_LOG(LS_INFO) << "texture is nullptr.";
-            return nullptr;
+            return false;
         }
 
         ID3D12Resource* readbackResource = reinterpret_cast<ID3D12Resource*>(d3dTexture2d->GetNativeTexturePtrV());
         assert(readbackResource);
         if (!readbackResource) // the texture has to be prepared for CPU access
-            return nullptr;
+            return false;
 
-        const int width = static_cast<int>(d3dTexture2d->GetWidth());
-        const int height = static_cast<int>(d3dTexture2d->GetHeight());
         const D3D12ResourceFootprint* footprint = d3dTexture2d->GetNativeTextureFootprint();
         const int rowPitch = static_cast<int>(footprint->Footprint.Footprint.RowPitch);
 
@@ -359,27 +357,15 @@ namespace webrtc
         assert(hr == S_OK);
         if (hr != S_OK)
         {
-            return nullptr;
+            return false;
         }
 
-        // RGBA -> I420
-        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer = webrtc::I420Buffer::Create(width, height);
-        libyuv::ARGBToI420(
-            static_cast<uint8_t*>(data),
-            rowPitch,
-            i420_buffer->MutableDataY(),
-            i420_buffer->StrideY(),
-            i420_buffer->MutableDataU(),
-            i420_buffer->StrideU(),
-            i420_buffer->MutableDataV(),
-            i420_buffer->StrideV(),
-            width,
-            height);
+        // BGRA
+        callback(static_cast<uint8_t*>(data), rowPitch, libyuv::FOURCC_ARGB);
 
         D3D12_RANGE emptyRange { 0, 0 };
         readbackResource->Unmap(0, &emptyRange);
-
-        return i420_buffer;
+        return true;
     }
 
     std::unique_ptr<GpuMemoryBufferHandle> D3D12GraphicsDevice::Map(ITexture2D* texture)
@@ -2,6 +2,7 @@
 
 #include "GpuMemoryBuffer.h"
 #include "GraphicsDevice.h"
+#include "Software/SoftwareGraphicsDevice.h"
 
 #if SUPPORT_D3D11 && SUPPORT_D3D12
 #include "D3D11/D3D11GraphicsDevice.h"
@@ -156,6 +157,10 @@ namespace webrtc
             break;
         }
 #endif
+        case kUnityGfxRendererNull:
+        {
+            return Init(rendererType, nullptr, nullptr, profiler);
+        }
         default:
         {
             return nullptr;
@@ -221,6 +226,12 @@ namespace webrtc
             break;
         }
 #endif
+        case kUnityGfxRendererNull:
+        {
+            // No GPU is required. Textures live in host memory.
+            pDevice = new SoftwareGraphicsDevice(renderer, profiler);
+            break;
+        }
         default:
         {
             DebugError("Unsupported Unity Renderer: %d", renderer);
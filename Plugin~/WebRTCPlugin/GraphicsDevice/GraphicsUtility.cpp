@@ -1,5 +1,9 @@
 #include "pch.h"
 
+#include <algorithm>
+
+#include <third_party/libyuv/include/libyuv.h>
+
 #include "GraphicsUtility.h"
 
 #if SUPPORT_VULKAN
@@ -27,5 +31,63 @@ namespace webrtc
         return textureHandle;
     }
 
+    void GraphicsUtility::ConvertRGBToI420(
+        const uint8_t* src,
+        int stride,
+        int width,
+        int height,
+        uint32_t fourcc,
+        webrtc::I420Buffer* dst,
+        ConversionThreadPool* threadPool)
+    {
+        RTC_DCHECK_EQ(width, dst->width());
+        RTC_DCHECK_EQ(height, dst->height());
+
+        auto convert = fourcc == libyuv::FOURCC_ABGR ? libyuv::ABGRToI420 : libyuv::ARGBToI420;
+
+        int bandCount = 1;
+        if (threadPool)
+            bandCount = std::clamp(height / kMinRowsPerConversionBand, 1, static_cast<int>(threadPool->threadCount()));
+        if (bandCount == 1)
+        {
+            convert(
+                src,
+                stride,
+                dst->MutableDataY(),
+                dst->StrideY(),
+                dst->MutableDataU(),
+                dst->StrideU(),
+                dst->MutableDataV(),
+                dst->StrideV(),
+                width,
+                height);
+            return;
+        }
+
+        // Each band starts on an even row, so every chroma row is made from the same two luma rows as in a single
+        // conversion and the output is identical.
+        const int rowsPerBand = ((height + bandCount - 1) / bandCount + 1) & ~1;
+        threadPool->ParallelFor(
+            static_cast<size_t>(bandCount),
+            [&](size_t index)
+            {
+                const int y = static_cast<int>(index) * rowsPerBand;
+                if (y >= height)
+                    return;
+                const int chromaY = y / 2;
+                convert(
+                    src + static_cast<ptrdiff_t>(y) * stride,
+                    stride,
+                    dst->MutableDataY() + y * dst->StrideY(),
+                    dst->StrideY(),
+                    dst->MutableDataU() + chromaY * dst->StrideU(),
+                    dst->StrideU(),
+                    dst->MutableDataV() + chromaY * dst->StrideV(),
+                    dst->StrideV(),
+                    width,
+                    std::min(rowsPerBand, height - y));
+            });
+    }
+
 } // end namespace webrtc
 } // end namespace unity
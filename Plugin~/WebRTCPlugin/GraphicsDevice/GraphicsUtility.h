@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ConversionThreadPool.h"
 #include "IGraphicsDevice.h"
 
 namespace unity
@@ -12,6 +13,20 @@ namespace webrtc
     public:
         static void*
         TextureHandleToNativeGraphicsPtr(void* textureHandle, IGraphicsDevice* device, UnityGfxRenderer renderer);
+
+        // Converts 32-bit RGB pixels to |dst|, which must have the same size. |fourcc| is libyuv::FOURCC_ARGB or
+        // libyuv::FOURCC_ABGR. Large images are split into bands of rows which run on |threadPool| if it is given.
+        static void ConvertRGBToI420(
+            const uint8_t* src,
+            int stride,
+            int width,
+            int height,
+            uint32_t fourcc,
+            ::webrtc::I420Buffer* dst,
+            ConversionThreadPool* threadPool = nullptr);
+
+        // Bands are not made smaller than this, because the synchronization costs more than converting a few rows.
+        static constexpr int kMinRowsPerConversionBand = 64;
     };
 
 } // end namespace webrtc
@@ -0,0 +1,81 @@
+#include "pch.h"
+
+#include "I420BufferPool.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    I420BufferPool::I420BufferPool()
+        : m_useCount(0)
+        , m_hitCount(0)
+        , m_missCount(0)
+    {
+    }
+
+    I420BufferPool::~I420BufferPool() = default;
+
+    rtc::scoped_refptr<webrtc::I420Buffer> I420BufferPool::CreateBuffer(int width, int height)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const std::pair<int, int> key(width, height);
+        auto it = m_pools.find(key);
+        if (it == m_pools.end())
+        {
+            // Forget the resolution which has not been used for the longest time. Its buffers in use stay alive.
+            if (m_pools.size() >= kMaxResolutions)
+            {
+                auto oldest = m_pools.begin();
+                for (auto entry = m_pools.begin(); entry != m_pools.end(); ++entry)
+                {
+                    if (entry->second.lastUse < oldest->second.lastUse)
+                        oldest = entry;
+                }
+                m_pools.erase(oldest);
+            }
+            Entry entry { std::make_unique<webrtc::VideoFrameBufferPool>(false, kMaxBuffersPerResolution), 0, {} };
+            it = m_pools.emplace(key, std::move(entry)).first;
+        }
+        Entry& entry = it->second;
+        entry.lastUse = ++m_useCount;
+
+        rtc::scoped_refptr<webrtc::I420Buffer> buffer = entry.pool->CreateI420Buffer(width, height);
+        if (!buffer)
+        {
+            m_missCount++;
+            return webrtc::I420Buffer::Create(width, height);
+        }
+        if (entry.buffers.insert(buffer.get()).second)
+            m_missCount++;
+        else
+            m_hitCount++;
+        return buffer;
+    }
+
+    void I420BufferPool::Release()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pools.clear();
+    }
+
+    size_t I420BufferPool::resolutionCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pools.size();
+    }
+
+    uint64_t I420BufferPool::hitCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_hitCount;
+    }
+
+    uint64_t I420BufferPool::missCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_missCount;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
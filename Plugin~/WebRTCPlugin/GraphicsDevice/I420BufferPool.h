@@ -0,0 +1,60 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+#include <api/video/i420_buffer.h>
+#include <common_video/include/video_frame_buffer_pool.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace webrtc = ::webrtc;
+
+    // Pool of I420 buffers keyed on the resolution. webrtc::VideoFrameBufferPool releases all of its buffers when
+    // another resolution is requested, so simulcast layers would never be reused with a single one.
+    // This class is thread safe.
+    class I420BufferPool
+    {
+    public:
+        static constexpr size_t kMaxBuffersPerResolution = 8;
+        static constexpr size_t kMaxResolutions = 8;
+
+        I420BufferPool();
+        I420BufferPool(const I420BufferPool&) = delete;
+        I420BufferPool& operator=(const I420BufferPool&) = delete;
+        ~I420BufferPool();
+
+        // Returns an unused buffer of the resolution. A buffer which is not pooled is returned when all of them are
+        // in use.
+        rtc::scoped_refptr<webrtc::I420Buffer> CreateBuffer(int width, int height);
+
+        // Drops all pooled buffers. Buffers in use stay valid.
+        void Release();
+
+        size_t resolutionCount();
+
+        // The number of requests served by a pooled buffer, and the number of requests which allocated one.
+        uint64_t hitCount();
+        uint64_t missCount();
+
+    private:
+        struct Entry
+        {
+            std::unique_ptr<webrtc::VideoFrameBufferPool> pool;
+            uint64_t lastUse;
+            // Buffers allocated by |pool|, to tell reused buffers from new ones.
+            std::unordered_set<const webrtc::I420Buffer*> buffers;
+        };
+
+        std::mutex m_mutex;
+        std::map<std::pair<int, int>, Entry> m_pools;
+        uint64_t m_useCount;
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
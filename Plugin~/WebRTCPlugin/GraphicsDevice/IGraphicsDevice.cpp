@@ -0,0 +1,101 @@
+#include "pch.h"
+
+#include <rtc_base/memory/aligned_malloc.h>
+#include <third_party/libyuv/include/libyuv.h>
+
+#include "GraphicsUtility.h"
+#include "IGraphicsDevice.h"
+#include "ITexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace webrtc = ::webrtc;
+
+    rtc::scoped_refptr<webrtc::I420Buffer> IGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    {
+        const int width = static_cast<int>(tex->GetWidth());
+        const int height = static_cast<int>(tex->GetHeight());
+        rtc::scoped_refptr<webrtc::I420Buffer> i420Buffer = m_i420BufferPool.CreateBuffer(width, height);
+
+        bool result = ReadPixels(
+            tex,
+            [&](const uint8_t* data, int stride, uint32_t fourcc)
+            {
+                GraphicsUtility::ConvertRGBToI420(
+                    data, stride, width, height, fourcc, i420Buffer.get(), &m_conversionThreadPool);
+            });
+        if (!result)
+            return nullptr;
+        return i420Buffer;
+    }
+
+    std::vector<rtc::scoped_refptr<webrtc::I420Buffer>>
+    IGraphicsDevice::ConvertRGBToScaledI420(ITexture2D* tex, const std::vector<Size>& sizes)
+    {
+        const Size textureSize(static_cast<int>(tex->GetWidth()), static_cast<int>(tex->GetHeight()));
+
+        std::vector<rtc::scoped_refptr<webrtc::I420Buffer>> buffers;
+        buffers.reserve(sizes.size());
+        size_t scaledBufferSize = 0;
+        for (const Size& size : sizes)
+        {
+            buffers.push_back(m_i420BufferPool.CreateBuffer(size.width(), size.height()));
+            if (size != textureSize)
+                scaledBufferSize = std::max(scaledBufferSize, static_cast<size_t>(size.width() * size.height() * 4));
+        }
+
+        // Scaled RGB images are written here before converting, one layer after another.
+        std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> scaled;
+        if (scaledBufferSize > 0)
+            scaled.reset(static_cast<uint8_t*>(webrtc::AlignedMalloc(scaledBufferSize, 64)));
+
+        bool result = ReadPixels(
+            tex,
+            [&](const uint8_t* data, int stride, uint32_t fourcc)
+            {
+                for (auto& buffer : buffers)
+                {
+                    const int width = buffer->width();
+                    const int height = buffer->height();
+                    if (Size(width, height) == textureSize)
+                    {
+                        GraphicsUtility::ConvertRGBToI420(
+                            data, stride, width, height, fourcc, buffer.get(), &m_conversionThreadPool);
+                        continue;
+                    }
+                    // Scaling does not depend on the channel order of 32-bit pixels.
+                    libyuv::ARGBScale(
+                        data,
+                        stride,
+                        textureSize.width(),
+                        textureSize.height(),
+                        scaled.get(),
+                        width * 4,
+                        width,
+                        height,
+                        libyuv::kFilterBox);
+                    GraphicsUtility::ConvertRGBToI420(
+                        scaled.get(), width * 4, width, height, fourcc, buffer.get(), &m_conversionThreadPool);
+                }
+            });
+        if (result)
+            return buffers;
+
+        // The device cannot map the texture, so scale the converted image instead.
+        rtc::scoped_refptr<webrtc::I420Buffer> source = ConvertRGBToI420(tex);
+        if (!source)
+            return {};
+        for (auto& buffer : buffers)
+        {
+            if (buffer->width() == source->width() && buffer->height() == source->height())
+                buffer = source;
+            else
+                buffer->ScaleFrom(*source);
+        }
+        return buffers;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -1,13 +1,18 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include <IUnityRenderingExtensions.h>
 #include <api/video/i420_buffer.h>
 
+#include "ConversionThreadPool.h"
+#include "I420BufferPool.h"
 #include "PlatformBase.h"
 #include "ProfilerMarkerFactory.h"
 #include "ScopedProfiler.h"
+#include "Size.h"
 
 #if CUDA_PLATFORM
 #include "Cuda/ICudaDevice.h"
@@ -60,12 +65,30 @@ namespace webrtc
         // Required for software encoding
         virtual ITexture2D*
         CreateCPUReadTextureV(uint32_t width, uint32_t height, UnityRenderingExtTextureFormat textureFormat) = 0;
-        virtual rtc::scoped_refptr<::webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex) = 0;
+        virtual rtc::scoped_refptr<::webrtc::I420Buffer> ConvertRGBToI420(ITexture2D* tex);
+
+        // Converts |tex| once for each of |sizes|, scaling the RGB image directly. The texture is read back only once,
+        // which is used for simulcast layers. Returns an empty vector on failure.
+        virtual std::vector<rtc::scoped_refptr<::webrtc::I420Buffer>>
+        ConvertRGBToScaledI420(ITexture2D* tex, const std::vector<Size>& sizes);
+
+        // Calls |callback| with the pixels of the CPU readable texture |tex|. |fourcc| is the libyuv name of the pixel
+        // layout, FOURCC_ARGB or FOURCC_ABGR. Returns false if the texture cannot be mapped.
+        using ReadPixelsCallback = std::function<void(const uint8_t* data, int stride, uint32_t fourcc)>;
+        virtual bool ReadPixels(ITexture2D* tex, const ReadPixelsCallback& callback) { return false; }
+
+        // Output buffers of the conversions to I420 are taken from this pool.
+        I420BufferPool* GetI420BufferPool() { return &m_i420BufferPool; }
+
+        // Threads which share the conversions to I420 with the calling thread.
+        ConversionThreadPool* GetConversionThreadPool() { return &m_conversionThreadPool; }
 
     protected:
         UnityGfxRenderer m_gfxRenderer;
         ProfilerMarkerFactory* m_profiler;
         std::chrono::nanoseconds m_syncTimeout;
+        I420BufferPool m_i420BufferPool;
+        ConversionThreadPool m_conversionThreadPool;
     };
 
 } // end namespace webrtc
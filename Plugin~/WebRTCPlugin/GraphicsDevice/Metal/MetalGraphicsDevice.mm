@@ -151,7 +151,9 @@ namespace webrtc
     rtc::scoped_refptr<webrtc::I420Buffer> MetalGraphicsDevice::ConvertRGBToI420(ITexture2D* texture)
     {
         MetalTexture2D* texture2D = static_cast<MetalTexture2D*>(texture);
-        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer = texture2D->ConvertI420Buffer();
+        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer = m_i420BufferPool.CreateBuffer(
+            static_cast<int>(texture2D->GetWidth()), static_cast<int>(texture2D->GetHeight()));
+        texture2D->ConvertI420Buffer(i420_buffer.get(), &m_conversionThreadPool);
 
         // Notify finishing usage of semaphore.
         dispatch_semaphore_t semaphore = texture2D->GetSemaphore();
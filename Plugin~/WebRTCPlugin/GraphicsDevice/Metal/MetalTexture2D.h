@@ -1,5 +1,6 @@
 #pragma once
 
+#include "GraphicsDevice/ConversionThreadPool.h"
 #include "GraphicsDevice/ITexture2D.h"
 #include "WebRTCMacros.h"
 
@@ -26,13 +27,12 @@ namespace webrtc
         void SetSemaphore(dispatch_semaphore_t semaphore) { m_semaphore = semaphore; }
         dispatch_semaphore_t GetSemaphore() const { return m_semaphore; }
 
-        rtc::scoped_refptr<I420Buffer> ConvertI420Buffer();
+        void ConvertI420Buffer(I420Buffer* dst, ConversionThreadPool* threadPool);
 
     private:
         id<MTLTexture> m_texture;
         dispatch_semaphore_t m_semaphore;
         std::vector<uint8_t> m_buffer;
-        rtc::scoped_refptr<I420Buffer> m_i420Buffer;
     };
 
     void* MetalTexture2D::GetNativeTexturePtrV() { return m_texture; }
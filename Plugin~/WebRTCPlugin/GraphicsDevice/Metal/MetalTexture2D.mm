@@ -2,7 +2,9 @@
 
 #include "MetalTexture2D.h"
 
-#include <third_party/libyuv/include/libyuv/convert.h>
+#include <third_party/libyuv/include/libyuv/video_common.h>
+
+#include "GraphicsDevice/GraphicsUtility.h"
 
 namespace unity
 {
@@ -26,11 +28,13 @@ namespace webrtc
         [m_texture release];
     }
 
-    rtc::scoped_refptr<I420Buffer> MetalTexture2D::ConvertI420Buffer()
+    void MetalTexture2D::ConvertI420Buffer(I420Buffer* dst, ConversionThreadPool* threadPool)
     {
         RTC_DCHECK(m_texture);
         RTC_DCHECK_GT(m_width, 0);
         RTC_DCHECK_GT(m_height, 0);
+        RTC_DCHECK_EQ(dst->width(), static_cast<int>(m_width));
+        RTC_DCHECK_EQ(dst->height(), static_cast<int>(m_height));
 
         const uint32_t BYTES_PER_PIXEL = 4;
         const uint32_t bytesPerRow = m_width * BYTES_PER_PIXEL;
@@ -44,22 +48,14 @@ namespace webrtc
                  fromRegion:MTLRegionMake2D(0, 0, m_width, m_height)
                 mipmapLevel:0];
 
-        if (!m_i420Buffer)
-            m_i420Buffer = I420Buffer::Create(static_cast<int32_t>(m_width), static_cast<int32_t>(m_height));
-
-        libyuv::ARGBToI420(
+        GraphicsUtility::ConvertRGBToI420(
             m_buffer.data(),
-            static_cast<int32_t>(bytesPerRow),
-            m_i420Buffer->MutableDataY(),
-            m_i420Buffer->StrideY(),
-            m_i420Buffer->MutableDataU(),
-            m_i420Buffer->StrideU(),
-            m_i420Buffer->MutableDataV(),
-            m_i420Buffer->StrideV(),
-            static_cast<int32_t>(m_width),
-            static_cast<int32_t>(m_height));
-
-        return m_i420Buffer;
+            static_cast<int>(bytesPerRow),
+            static_cast<int>(m_width),
+            static_cast<int>(m_height),
+            libyuv::FOURCC_ARGB,
+            dst,
+            threadPool);
     }
 
 } // end namespace webrtc
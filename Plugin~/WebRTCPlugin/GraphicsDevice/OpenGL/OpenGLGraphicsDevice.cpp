@@ -216,7 +216,7 @@ namespace webrtc
 #endif
     }
 
-    rtc::scoped_refptr<webrtc::I420Buffer> OpenGLGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    bool OpenGLGraphicsDevice::ReadPixels(ITexture2D* tex, const ReadPixelsCallback& callback)
     {
         if (!OpenGLContext::CurrentContext())
             contexts_.push_back(OpenGLContext::CreateGLContext(mainContext_.get()));
@@ -226,7 +226,6 @@ namespace webrtc
         const GLuint pbo = sourceTex->GetPBO();
         const GLenum format = GL_RGBA;
         const uint32_t width = sourceTex->GetWidth();
-        const uint32_t height = sourceTex->GetHeight();
         const uint32_t bufferSize = sourceTex->GetBufferSize();
         byte* data = sourceTex->GetBuffer();
 
@@ -245,20 +244,9 @@ namespace webrtc
         glBindTexture(GL_TEXTURE_2D, 0);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-        // RGBA -> I420
-        rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer = webrtc::I420Buffer::Create(width, height);
-        libyuv::ABGRToI420(
-            static_cast<uint8_t*>(data),
-            width * 4,
-            i420_buffer->MutableDataY(),
-            width,
-            i420_buffer->MutableDataU(),
-            (width + 1) / 2,
-            i420_buffer->MutableDataV(),
-            (width + 1) / 2,
-            width,
-            height);
-        return i420_buffer;
+        // RGBA
+        callback(static_cast<uint8_t*>(data), static_cast<int>(width * 4), libyuv::FOURCC_ABGR);
+        return true;
     }
 
     std::unique_ptr<GpuMemoryBufferHandle> OpenGLGraphicsDevice::Map(ITexture2D* texture)
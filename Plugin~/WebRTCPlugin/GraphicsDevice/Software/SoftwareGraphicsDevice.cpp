@@ -0,0 +1,159 @@
+#include "pch.h"
+
+#include <cstring>
+
+#include "third_party/libyuv/include/libyuv.h"
+
+#include "GpuMemoryBuffer.h"
+#include "SoftwareGraphicsDevice.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    // Cache line alignment keeps the libyuv row functions on their SIMD paths.
+    static constexpr size_t kBufferAlignment = 64;
+
+    // Upper bound of free buffers kept for each allocation size.
+    static constexpr size_t kMaxPooledBuffersPerSize = 8;
+
+    SoftwareGraphicsDevice::SoftwareGraphicsDevice(UnityGfxRenderer renderer, ProfilerMarkerFactory* profiler)
+        : IGraphicsDevice(renderer, profiler)
+        , m_bufferPool(std::make_shared<SoftwareBufferPool>())
+    {
+    }
+
+    SoftwareGraphicsDevice::~SoftwareGraphicsDevice() { }
+
+    bool SoftwareGraphicsDevice::InitV() { return true; }
+
+    void SoftwareGraphicsDevice::ShutdownV() { m_bufferPool->Clear(); }
+
+    ITexture2D*
+    SoftwareGraphicsDevice::CreateDefaultTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat)
+    {
+        if (w == 0 || h == 0)
+            return nullptr;
+
+        const size_t size = static_cast<size_t>(w) * h * SoftwareTexture2D::kBytesPerPixel;
+        AlignedBuffer buffer = m_bufferPool->Allocate(size);
+        if (!buffer)
+            return nullptr;
+
+        std::weak_ptr<SoftwareBufferPool> pool = m_bufferPool;
+        SoftwareTexture2D::ReleaseSoftwareTextureCallback callback = [pool](SoftwareTexture2D* texture)
+        {
+            const size_t bufferSize = texture->GetBufferSize();
+            AlignedBuffer released = texture->ReleaseBuffer();
+            if (std::shared_ptr<SoftwareBufferPool> owner = pool.lock())
+                owner->Release(std::move(released), bufferSize);
+        };
+        return new SoftwareTexture2D(w, h, textureFormat, std::move(buffer), callback);
+    }
+
+    ITexture2D*
+    SoftwareGraphicsDevice::CreateCPUReadTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat)
+    {
+        // Every texture is readable from CPU on this device.
+        return CreateDefaultTextureV(w, h, textureFormat);
+    }
+
+    bool SoftwareGraphicsDevice::CopyResourceV(ITexture2D* dest, ITexture2D* src)
+    {
+        SoftwareTexture2D* srcTexture = static_cast<SoftwareTexture2D*>(src);
+        SoftwareTexture2D* dstTexture = static_cast<SoftwareTexture2D*>(dest);
+        if (srcTexture == dstTexture)
+            return false;
+        if (!srcTexture->IsSize(dstTexture->GetWidth(), dstTexture->GetHeight()))
+        {
+            RTC_LOG(LS_INFO) << "texture size is not same";
+            return false;
+        }
+        return CopyResourceFromNativeV(dest, srcTexture->GetBuffer());
+    }
+
+    bool SoftwareGraphicsDevice::CopyResourceFromNativeV(ITexture2D* dest, NativeTexPtr nativeTexturePtr)
+    {
+        SoftwareTexture2D* texture = static_cast<SoftwareTexture2D*>(dest);
+        if (!nativeTexturePtr)
+        {
+            RTC_LOG(LS_INFO) << "nativeTexturePtr is nullptr";
+            return false;
+        }
+        uint8_t* dst = texture->GetBuffer();
+        if (dst == nativeTexturePtr)
+        {
+            RTC_LOG(LS_INFO) << "Same texture";
+            return false;
+        }
+        std::memcpy(dst, nativeTexturePtr, texture->GetBufferSize());
+        return true;
+    }
+
+    bool SoftwareGraphicsDevice::ReadPixels(ITexture2D* tex, const ReadPixelsCallback& callback)
+    {
+        SoftwareTexture2D* texture = static_cast<SoftwareTexture2D*>(tex);
+        const int pitch = static_cast<int>(texture->GetPitch());
+
+        // libyuv names formats in little-endian word order, so the byte order R,G,B,A is "ABGR".
+        switch (texture->GetFormat())
+        {
+        case kUnityRenderingExtFormatR8G8B8A8_SRGB:
+        case kUnityRenderingExtFormatR8G8B8A8_UNorm:
+        case kUnityRenderingExtFormatR8G8B8A8_SNorm:
+        case kUnityRenderingExtFormatR8G8B8A8_UInt:
+        case kUnityRenderingExtFormatR8G8B8A8_SInt:
+            callback(texture->GetBuffer(), pitch, libyuv::FOURCC_ABGR);
+            break;
+        default:
+            callback(texture->GetBuffer(), pitch, libyuv::FOURCC_ARGB);
+            break;
+        }
+        return true;
+    }
+
+    size_t SoftwareGraphicsDevice::pooledBufferCount() { return m_bufferPool->size(); }
+
+    AlignedBuffer SoftwareBufferPool::Allocate(size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_buffers.find(size);
+            if (it != m_buffers.end() && !it->second.empty())
+            {
+                AlignedBuffer buffer = std::move(it->second.back());
+                it->second.pop_back();
+                return buffer;
+            }
+        }
+        return AlignedBuffer(static_cast<uint8_t*>(::webrtc::AlignedMalloc(size, kBufferAlignment)));
+    }
+
+    void SoftwareBufferPool::Release(AlignedBuffer buffer, size_t size)
+    {
+        if (!buffer)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<AlignedBuffer>& buffers = m_buffers[size];
+        if (buffers.size() < kMaxPooledBuffersPerSize)
+            buffers.push_back(std::move(buffer));
+    }
+
+    void SoftwareBufferPool::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.clear();
+    }
+
+    size_t SoftwareBufferPool::size()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t count = 0;
+        for (const auto& pair : m_buffers)
+            count += pair.second.size();
+        return count;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
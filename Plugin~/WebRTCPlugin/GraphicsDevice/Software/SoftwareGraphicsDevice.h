@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "GraphicsDevice/IGraphicsDevice.h"
+#include "SoftwareTexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace webrtc = ::webrtc;
+
+    // Free lists of host buffers, keyed by size. The textures refer to the pool weakly, so a texture which outlives
+    // its device frees its buffer instead of returning it.
+    class SoftwareBufferPool
+    {
+    public:
+        AlignedBuffer Allocate(size_t size);
+        void Release(AlignedBuffer buffer, size_t size);
+        void Clear();
+        size_t size();
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_map<size_t, std::vector<AlignedBuffer>> m_buffers;
+    };
+
+    // Graphics device which keeps every texture in host memory. It does not need any GPU,
+    // so the capture and encode pipeline can run on headless machines and in CI.
+    // The native texture pointer passed to CopyResourceFromNativeV must point to tightly
+    // packed pixels which have the same size and format as the destination texture.
+    class SoftwareGraphicsDevice : public IGraphicsDevice
+    {
+    public:
+        SoftwareGraphicsDevice(UnityGfxRenderer renderer, ProfilerMarkerFactory* profiler);
+        ~SoftwareGraphicsDevice() override;
+
+        bool InitV() override;
+        void ShutdownV() override;
+        void* GetEncodeDevicePtrV() override { return nullptr; }
+
+        ITexture2D*
+        CreateDefaultTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat) override;
+        ITexture2D*
+        CreateCPUReadTextureV(uint32_t w, uint32_t h, UnityRenderingExtTextureFormat textureFormat) override;
+        bool CopyResourceV(ITexture2D* dest, ITexture2D* src) override;
+        bool CopyResourceFromNativeV(ITexture2D* dest, NativeTexPtr nativeTexturePtr) override;
+        std::unique_ptr<GpuMemoryBufferHandle> Map(ITexture2D* texture) override { return nullptr; }
+        bool WaitSync(const ITexture2D* texture) override { return true; }
+        bool ResetSync(const ITexture2D* texture) override { return true; }
+        bool WaitIdleForTest() override { return true; }
+        bool ReadPixels(ITexture2D* tex, const ReadPixelsCallback& callback) override;
+
+#if CUDA_PLATFORM
+        bool IsCudaSupport() override { return false; }
+        CUcontext GetCUcontext() override { return nullptr; }
+        NV_ENC_BUFFER_FORMAT GetEncodeBufferFormat() override { return NV_ENC_BUFFER_FORMAT_UNDEFINED; }
+#endif
+
+        // The number of host buffers kept for reuse.
+        size_t pooledBufferCount();
+
+    private:
+        std::shared_ptr<SoftwareBufferPool> m_bufferPool;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
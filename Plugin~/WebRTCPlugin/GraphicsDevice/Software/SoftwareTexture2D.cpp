@@ -0,0 +1,30 @@
+#include "pch.h"
+
+#include "SoftwareTexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    SoftwareTexture2D::SoftwareTexture2D(
+        uint32_t w,
+        uint32_t h,
+        UnityRenderingExtTextureFormat format,
+        AlignedBuffer buffer,
+        ReleaseSoftwareTextureCallback callback)
+        : ITexture2D(w, h)
+        , m_format(format)
+        , m_buffer(std::move(buffer))
+        , m_callback(callback)
+    {
+        RTC_DCHECK(m_buffer);
+    }
+
+    SoftwareTexture2D::~SoftwareTexture2D()
+    {
+        if (m_callback)
+            m_callback(this);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
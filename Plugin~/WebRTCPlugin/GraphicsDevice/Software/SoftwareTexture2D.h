@@ -0,0 +1,55 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <IUnityRenderingExtensions.h>
+#include <rtc_base/memory/aligned_malloc.h>
+
+#include "GraphicsDevice/ITexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    using AlignedBuffer = std::unique_ptr<uint8_t, ::webrtc::AlignedFreeDeleter>;
+
+    // Texture backed by host memory. The pixels are tightly packed with 4 bytes per pixel,
+    // and the native texture pointer is the address of the first pixel.
+    class SoftwareTexture2D : public ITexture2D
+    {
+    public:
+        using ReleaseSoftwareTextureCallback = std::function<void(SoftwareTexture2D*)>;
+
+        static constexpr size_t kBytesPerPixel = 4;
+
+        SoftwareTexture2D(
+            uint32_t w,
+            uint32_t h,
+            UnityRenderingExtTextureFormat format,
+            AlignedBuffer buffer,
+            ReleaseSoftwareTextureCallback callback);
+        ~SoftwareTexture2D() override;
+
+        void* GetNativeTexturePtrV() override { return m_buffer.get(); }
+        const void* GetNativeTexturePtrV() const override { return m_buffer.get(); }
+        void* GetEncodeTexturePtrV() override { return m_buffer.get(); }
+        const void* GetEncodeTexturePtrV() const override { return m_buffer.get(); }
+
+        UnityRenderingExtTextureFormat GetFormat() const { return m_format; }
+        size_t GetPitch() const { return m_width * kBytesPerPixel; }
+        size_t GetBufferSize() const { return GetPitch() * m_height; }
+        uint8_t* GetBuffer() { return m_buffer.get(); }
+        const uint8_t* GetBuffer() const { return m_buffer.get(); }
+
+        // Hands the host memory back to the owner. The texture is unusable after calling this.
+        AlignedBuffer ReleaseBuffer() { return std::move(m_buffer); }
+
+    private:
+        UnityRenderingExtTextureFormat m_format;
+        AlignedBuffer m_buffer;
+        ReleaseSoftwareTextureCallback m_callback;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -1,6 +1,6 @@
 #include "pch.h"
 
-#include <third_party/libyuv/include/libyuv/convert.h>
+#include <third_party/libyuv/include/libyuv/video_common.h>
 
 #include "GraphicsDevice/GraphicsUtility.h"
 #include "UnityVulkanInterfaceFunctions.h"
@@ -369,11 +369,9 @@ namespace webrtc
         return true;
     }
 
-    rtc::scoped_refptr<webrtc::I420Buffer> VulkanGraphicsDevice::ConvertRGBToI420(ITexture2D* tex)
+    bool VulkanGraphicsDevice::ReadPixels(ITexture2D* tex, const ReadPixelsCallback& callback)
     {
         VulkanTexture2D* vulkanTexture = static_cast<VulkanTexture2D*>(tex);
-        const int32_t width = static_cast<int32_t>(tex->GetWidth());
-        const int32_t height = static_cast<int32_t>(tex->GetHeight());
         const int32_t rowPitch = static_cast<int32_t>(vulkanTexture->GetPitch());
 
         VkDeviceMemory textureImageMemory = vulkanTexture->GetTextureImageMemory();
@@ -382,25 +380,12 @@ namespace webrtc
         if (vkMapMemory(m_Instance.device, textureImageMemory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS)
         {
             RTC_LOG(LS_INFO) << "vkMapMemory failed.";
-            return nullptr;
+            return false;
         }
 
-        // convert format to i420
-        rtc::scoped_refptr<webrtc::I420Buffer> i420Buffer = webrtc::I420Buffer::Create(width, height);
-        libyuv::ARGBToI420(
-            (const uint8_t*)data,
-            rowPitch,
-            i420Buffer->MutableDataY(),
-            i420Buffer->StrideY(),
-            i420Buffer->MutableDataU(),
-            i420Buffer->StrideU(),
-            i420Buffer->MutableDataV(),
-            i420Buffer->StrideV(),
-            width,
-            height);
+        callback(static_cast<const uint8_t*>(data), rowPitch, libyuv::FOURCC_ARGB);
         vkUnmapMemory(m_Instance.device, textureImageMemory);
-
-        return i420Buffer;
+        return true;
     }
 
     std::unique_ptr<GpuMemoryBufferHandle> VulkanGraphicsDevice::Map(ITexture2D* texture)
@@ -0,0 +1,118 @@
+#include "pch.h"
+
+#include <third_party/libyuv/include/libyuv.h>
+
+#include "I420ToRGBConverter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    constexpr size_t kScratchAlignment = 64;
+
+    I420ToRGBConverter::I420ToRGBConverter()
+        : m_scratchSize(0)
+    {
+    }
+
+    I420ToRGBConverter::~I420ToRGBConverter() = default;
+
+    bool I420ToRGBConverter::Convert(
+        const webrtc::I420BufferInterface& src, int width, int height, uint32_t fourcc, bool flipVertical, uint8_t* dst)
+    {
+        const int srcWidth = src.width();
+        const int srcHeight = src.height();
+
+        if (width == srcWidth && height == srcHeight)
+        {
+            return libyuv::ConvertFromI420(
+                       src.DataY(),
+                       src.StrideY(),
+                       src.DataU(),
+                       src.StrideU(),
+                       src.DataV(),
+                       src.StrideV(),
+                       dst,
+                       0,
+                       width,
+                       flipVertical ? -height : height,
+                       fourcc) == 0;
+        }
+
+        if (static_cast<int64_t>(width) * height < static_cast<int64_t>(srcWidth) * srcHeight)
+        {
+            const int chromaWidth = (width + 1) / 2;
+            const int chromaHeight = (height + 1) / 2;
+            const size_t lumaSize = static_cast<size_t>(width) * height;
+            const size_t chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+            uint8_t* y = Scratch(lumaSize + chromaSize * 2);
+            uint8_t* u = y + lumaSize;
+            uint8_t* v = u + chromaSize;
+
+            int result = libyuv::I420Scale(
+                src.DataY(),
+                src.StrideY(),
+                src.DataU(),
+                src.StrideU(),
+                src.DataV(),
+                src.StrideV(),
+                srcWidth,
+                srcHeight,
+                y,
+                width,
+                u,
+                chromaWidth,
+                v,
+                chromaWidth,
+                width,
+                height,
+                libyuv::kFilterBox);
+            if (result)
+                return false;
+            return libyuv::ConvertFromI420(
+                       y,
+                       width,
+                       u,
+                       chromaWidth,
+                       v,
+                       chromaWidth,
+                       dst,
+                       0,
+                       width,
+                       flipVertical ? -height : height,
+                       fourcc) == 0;
+        }
+
+        // Scaling does not depend on the channel order of 32-bit pixels.
+        const int rgbStride = srcWidth * 4;
+        uint8_t* rgb = Scratch(static_cast<size_t>(rgbStride) * srcHeight);
+        int result = libyuv::ConvertFromI420(
+            src.DataY(),
+            src.StrideY(),
+            src.DataU(),
+            src.StrideU(),
+            src.DataV(),
+            src.StrideV(),
+            rgb,
+            rgbStride,
+            srcWidth,
+            flipVertical ? -srcHeight : srcHeight,
+            fourcc);
+        if (result)
+            return false;
+        return libyuv::ARGBScale(
+                   rgb, rgbStride, srcWidth, srcHeight, dst, width * 4, width, height, libyuv::kFilterBilinear) == 0;
+    }
+
+    uint8_t* I420ToRGBConverter::Scratch(size_t size)
+    {
+        if (m_scratchSize < size)
+        {
+            m_scratch.reset(static_cast<uint8_t*>(webrtc::AlignedMalloc(size, kScratchAlignment)));
+            m_scratchSize = size;
+        }
+        return m_scratch.get();
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+
+#include <api/video/video_frame_buffer.h>
+#include <rtc_base/memory/aligned_malloc.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace webrtc = ::webrtc;
+
+    // Converts I420 frames to 32-bit RGB pixels of another size. The smaller of the two images is the one which is
+    // color converted: a downscale resizes the planes first, an upscale converts first and resizes the RGB pixels.
+    // The intermediate image is kept between calls, so converting a stream of frames does not allocate.
+    // This class is not thread safe.
+    class I420ToRGBConverter
+    {
+    public:
+        I420ToRGBConverter();
+        I420ToRGBConverter(const I420ToRGBConverter&) = delete;
+        I420ToRGBConverter& operator=(const I420ToRGBConverter&) = delete;
+        ~I420ToRGBConverter();
+
+        // Writes |src| to |dst| as |width| x |height| pixels with a stride of |width| * 4. |fourcc| is a libyuv
+        // 32-bit format such as FOURCC_ARGB. Returns false if the format is not supported.
+        bool Convert(
+            const webrtc::I420BufferInterface& src,
+            int width,
+            int height,
+            uint32_t fourcc,
+            bool flipVertical,
+            uint8_t* dst);
+
+        size_t scratchSize() const { return m_scratchSize; }
+
+    private:
+        uint8_t* Scratch(size_t size);
+
+        std::unique_ptr<uint8_t, webrtc::AlignedFreeDeleter> m_scratch;
+        size_t m_scratchSize;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Unbounded queue which passes values from one producer thread to one consumer thread without locking.
+    // The values are kept in a linked list whose first node has already been taken. The producer reuses the nodes
+    // the consumer has gone past, so it only allocates while the queue grows.
+    template<typename T>
+    class SpscQueue
+    {
+    public:
+        SpscQueue()
+        {
+            Node* node = new Node();
+            m_tail.store(node, std::memory_order_relaxed);
+            m_head = node;
+            m_first = node;
+            m_tailCopy = node;
+        }
+
+        ~SpscQueue()
+        {
+            Node* node = m_first;
+            while (node != nullptr)
+            {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Producer: adds |value| at the end of the queue.
+        void Push(T value)
+        {
+            Node* node = AllocateNode();
+            node->value = std::move(value);
+            node->next.store(nullptr, std::memory_order_relaxed);
+            m_head->next.store(node, std::memory_order_release);
+            m_head = node;
+        }
+
+        // Consumer: takes the first value of the queue. Returns false if the queue is empty.
+        bool Pop(T* value)
+        {
+            Node* tail = m_tail.load(std::memory_order_relaxed);
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr)
+                return false;
+            *value = std::move(next->value);
+            m_tail.store(next, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        struct Node
+        {
+            std::atomic<Node*> next { nullptr };
+            T value {};
+        };
+
+        Node* AllocateNode()
+        {
+            // The nodes from m_first to m_tailCopy have been taken by the consumer.
+            if (m_first == m_tailCopy)
+                m_tailCopy = m_tail.load(std::memory_order_acquire);
+            if (m_first != m_tailCopy)
+            {
+                Node* node = m_first;
+                m_first = node->next.load(std::memory_order_relaxed);
+                return node;
+            }
+            return new Node();
+        }
+
+        // Consumer: the node of the last taken value.
+        std::atomic<Node*> m_tail;
+        // Producer: the last node, the oldest node and the node of the last taken value seen by the producer.
+        Node* m_head;
+        Node* m_first;
+        Node* m_tailCopy;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
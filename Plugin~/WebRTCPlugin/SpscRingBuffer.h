@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Ring buffer which passes samples from one producer thread to one consumer thread without locking.
+    // The indices only grow, so the buffered length is their difference and a full buffer is told from an empty one.
+    template<typename T>
+    class SpscRingBuffer
+    {
+    public:
+        SpscRingBuffer() = default;
+        SpscRingBuffer(const SpscRingBuffer&) = delete;
+        SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+        // Drops the buffered samples and allocates |capacity| samples. Neither side may use the buffer meanwhile.
+        void Reset(size_t capacity)
+        {
+            m_data.assign(capacity, T());
+            m_writeIndex.store(0, std::memory_order_relaxed);
+            m_readIndex.store(0, std::memory_order_relaxed);
+        }
+
+        size_t capacity() const { return m_data.size(); }
+
+        // Buffered samples. The other side may change it at any time, so the consumer gets a lower bound and the
+        // producer an upper bound.
+        size_t size() const
+        {
+            // Loading the read index first keeps the result from going below zero.
+            const size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+            const size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+            return writeIndex - readIndex;
+        }
+
+        // Producer: writes as many of |count| samples as fit, and returns the written count.
+        size_t Write(const T* data, size_t count)
+        {
+            const size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+            const size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+            count = std::min(count, capacity() - (writeIndex - readIndex));
+            if (count == 0)
+                return 0;
+
+            const size_t offset = writeIndex % capacity();
+            const size_t first = std::min(count, capacity() - offset);
+            std::memcpy(m_data.data() + offset, data, first * sizeof(T));
+            std::memcpy(m_data.data(), data + first, (count - first) * sizeof(T));
+            m_writeIndex.store(writeIndex + count, std::memory_order_release);
+            return count;
+        }
+
+        // Consumer: passes up to |count| buffered samples to |consume| as at most two contiguous segments, and
+        // returns the read count.
+        template<typename Consume>
+        size_t Read(size_t count, Consume&& consume)
+        {
+            const size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+            const size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+            count = std::min(count, writeIndex - readIndex);
+            if (count == 0)
+                return 0;
+
+            const size_t offset = readIndex % capacity();
+            const size_t first = std::min(count, capacity() - offset);
+            consume(m_data.data() + offset, first);
+            if (count > first)
+                consume(m_data.data(), count - first);
+            m_readIndex.store(readIndex + count, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        std::vector<T> m_data;
+        std::atomic<size_t> m_writeIndex { 0 };
+        std::atomic<size_t> m_readIndex { 0 };
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,312 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "StatsReportSerializer.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace
+    {
+        template<typename T>
+        struct StatsMemberTypeOf;
+
+        template<>
+        struct StatsMemberTypeOf<bool>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::Bool;
+        };
+        template<>
+        struct StatsMemberTypeOf<int32_t>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::Int32;
+        };
+        template<>
+        struct StatsMemberTypeOf<uint32_t>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::Uint32;
+        };
+        template<>
+        struct StatsMemberTypeOf<int64_t>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::Int64;
+        };
+        template<>
+        struct StatsMemberTypeOf<uint64_t>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::Uint64;
+        };
+        template<>
+        struct StatsMemberTypeOf<double>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::Double;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::string>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::String;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::vector<bool>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::SequenceBool;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::vector<int32_t>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::SequenceInt32;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::vector<uint32_t>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::SequenceUint32;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::vector<int64_t>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::SequenceInt64;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::vector<uint64_t>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::SequenceUint64;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::vector<double>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::SequenceDouble;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::vector<std::string>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::SequenceString;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::map<std::string, uint64_t>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::MapStringUint64;
+        };
+        template<>
+        struct StatsMemberTypeOf<std::map<std::string, double>>
+        {
+            static constexpr StatsMemberType value = StatsMemberType::MapStringDouble;
+        };
+
+        size_t Align8(size_t size) { return (size + 7) & ~size_t { 7 }; }
+    }
+
+    size_t StatsReportSerializer::Serialize(
+        const RTCStatsReport& report, const StatsReportFilter& filter, const RTCStatsReport* previous)
+    {
+        m_stats.clear();
+        m_members.clear();
+        m_data.clear();
+        m_strings.clear();
+        m_chars.clear();
+        m_stringIndices.clear();
+
+        auto selected = [&filter](const RTCStats& stats)
+        {
+            return filter.types.empty() ||
+                std::find(filter.types.begin(), filter.types.end(), stats.type()) != filter.types.end();
+        };
+
+        m_stats.reserve(report.size());
+        for (const RTCStats& stats : report)
+        {
+            if (!selected(stats))
+                continue;
+
+            const RTCStats* previousStats = previous != nullptr ? previous->Get(stats.id()) : nullptr;
+            std::vector<Attribute> previousAttributes;
+            if (previousStats != nullptr && std::strcmp(previousStats->type(), stats.type()) == 0)
+                previousAttributes = previousStats->Attributes();
+
+            StatsRecord record = {};
+            record.firstMember = static_cast<uint32_t>(m_members.size());
+            std::vector<Attribute> attributes = stats.Attributes();
+            for (size_t i = 0; i < attributes.size(); i++)
+            {
+                const Attribute& attribute = attributes[i];
+                if (!filter.members.empty() &&
+                    std::find(filter.members.begin(), filter.members.end(), attribute.name()) == filter.members.end())
+                    continue;
+                // The attributes of stats of the same type are always in the same order.
+                if (i < previousAttributes.size() && !Changed(attribute, previousAttributes[i]))
+                    continue;
+                AddMember(attribute);
+            }
+            record.memberCount = static_cast<uint32_t>(m_members.size()) - record.firstMember;
+            if (!previousAttributes.empty() && record.memberCount == 0)
+                continue;
+
+            record.id = Intern(stats.id());
+            record.type = Intern(stats.type());
+            record.timestamp = stats.timestamp().us();
+            m_stats.push_back(record);
+        }
+
+        if (previous != nullptr)
+        {
+            for (const RTCStats& stats : *previous)
+            {
+                if (!selected(stats) || report.Get(stats.id()) != nullptr)
+                    continue;
+
+                StatsRecord record = {};
+                record.id = Intern(stats.id());
+                record.type = Intern(stats.type());
+                record.timestamp = report.timestamp().us();
+                record.firstMember = static_cast<uint32_t>(m_members.size());
+                record.flags = kStatsRemoved;
+                m_stats.push_back(record);
+            }
+        }
+        m_stringIndices.clear();
+
+        m_header = {};
+        m_header.version = kVersion;
+        m_header.statsCount = static_cast<uint32_t>(m_stats.size());
+        m_header.statsOffset = static_cast<uint32_t>(Align8(sizeof(Header)));
+        m_header.memberCount = static_cast<uint32_t>(m_members.size());
+        m_header.memberOffset = m_header.statsOffset + m_header.statsCount * sizeof(StatsRecord);
+        m_header.dataOffset = m_header.memberOffset + m_header.memberCount * sizeof(MemberRecord);
+        m_header.stringCount = static_cast<uint32_t>(m_strings.size());
+        m_header.stringOffset = static_cast<uint32_t>(Align8(m_header.dataOffset + m_data.size()));
+        m_header.charsOffset = m_header.stringOffset + m_header.stringCount * sizeof(StringEntry);
+        m_header.size = m_header.charsOffset + static_cast<uint32_t>(m_chars.size());
+        return m_header.size;
+    }
+
+    void StatsReportSerializer::CopyTo(uint8_t* dst) const
+    {
+        // Clears the padding between the sections.
+        std::memset(dst, 0, m_header.charsOffset);
+        std::memcpy(dst, &m_header, sizeof(m_header));
+        if (!m_stats.empty())
+            std::memcpy(dst + m_header.statsOffset, m_stats.data(), m_stats.size() * sizeof(StatsRecord));
+        if (!m_members.empty())
+            std::memcpy(dst + m_header.memberOffset, m_members.data(), m_members.size() * sizeof(MemberRecord));
+        if (!m_data.empty())
+            std::memcpy(dst + m_header.dataOffset, m_data.data(), m_data.size());
+        if (!m_strings.empty())
+            std::memcpy(dst + m_header.stringOffset, m_strings.data(), m_strings.size() * sizeof(StringEntry));
+        if (!m_chars.empty())
+            std::memcpy(dst + m_header.charsOffset, m_chars.data(), m_chars.size());
+    }
+
+    uint32_t StatsReportSerializer::Intern(std::string_view str)
+    {
+        auto result = m_stringIndices.emplace(str, static_cast<uint32_t>(m_strings.size()));
+        if (!result.second)
+            return result.first->second;
+
+        StringEntry entry = { static_cast<uint32_t>(m_chars.size()), static_cast<uint32_t>(str.size()) };
+        m_strings.push_back(entry);
+        m_chars.insert(m_chars.end(), str.begin(), str.end());
+        m_chars.push_back('\0');
+        return result.first->second;
+    }
+
+    uint32_t StatsReportSerializer::AppendData(const void* data, size_t size)
+    {
+        const size_t offset = Align8(m_data.size());
+        m_data.resize(offset + size);
+        if (size > 0)
+            std::memcpy(m_data.data() + offset, data, size);
+        return static_cast<uint32_t>(offset);
+    }
+
+    template<typename T>
+    void StatsReportSerializer::WriteValue(const T& value, MemberRecord* record)
+    {
+        static_assert(std::is_arithmetic<T>::value && sizeof(T) <= sizeof(record->value), "Unsupported member type");
+        std::memcpy(&record->value, &value, sizeof(T));
+    }
+
+    void StatsReportSerializer::WriteValue(const std::string& value, MemberRecord* record)
+    {
+        record->value = Intern(value);
+    }
+
+    template<typename T>
+    void StatsReportSerializer::WriteValue(const std::vector<T>& values, MemberRecord* record)
+    {
+        record->count = static_cast<uint32_t>(values.size());
+        record->offset = AppendData(values.data(), values.size() * sizeof(T));
+    }
+
+    void StatsReportSerializer::WriteValue(const std::vector<bool>& values, MemberRecord* record)
+    {
+        const size_t offset = Align8(m_data.size());
+        m_data.resize(offset + values.size());
+        for (size_t i = 0; i < values.size(); i++)
+            m_data[offset + i] = values[i] ? 1 : 0;
+        record->count = static_cast<uint32_t>(values.size());
+        record->offset = static_cast<uint32_t>(offset);
+    }
+
+    void StatsReportSerializer::WriteValue(const std::vector<std::string>& values, MemberRecord* record)
+    {
+        m_indices.clear();
+        for (const std::string& value : values)
+            m_indices.push_back(Intern(value));
+        record->count = static_cast<uint32_t>(values.size());
+        record->offset = AppendData(m_indices.data(), m_indices.size() * sizeof(uint32_t));
+    }
+
+    template<typename T>
+    void StatsReportSerializer::WriteValue(const std::map<std::string, T>& values, MemberRecord* record)
+    {
+        m_indices.clear();
+        for (const auto& pair : values)
+            m_indices.push_back(Intern(pair.first));
+        record->count = static_cast<uint32_t>(values.size());
+        record->offset = AppendData(m_indices.data(), m_indices.size() * sizeof(uint32_t));
+
+        size_t offset = Align8(m_data.size());
+        m_data.resize(offset + values.size() * sizeof(T));
+        for (const auto& pair : values)
+        {
+            std::memcpy(m_data.data() + offset, &pair.second, sizeof(T));
+            offset += sizeof(T);
+        }
+    }
+
+    bool StatsReportSerializer::Changed(const Attribute& attribute, const Attribute& previous)
+    {
+        const auto& previousVariant = previous.as_variant();
+        return std::visit(
+            [&previousVariant](const auto* value)
+            {
+                using T = std::decay_t<decltype(value)>;
+                const T* previousValue = std::get_if<T>(&previousVariant);
+                return previousValue == nullptr || **previousValue != *value;
+            },
+            attribute.as_variant());
+    }
+
+    void StatsReportSerializer::AddMember(const Attribute& attribute)
+    {
+        MemberRecord record = {};
+        record.name = Intern(attribute.name());
+        std::visit(
+            [this, &record](const auto* value)
+            {
+                using T = typename std::decay_t<decltype(*value)>::value_type;
+                record.type = StatsMemberTypeOf<T>::value;
+                if (!value->has_value())
+                    return;
+                record.defined = 1;
+                WriteValue(value->value(), &record);
+            },
+            attribute.as_variant());
+        m_members.push_back(record);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <api/stats/rtc_stats_report.h>
+
+namespace unity
+{
+namespace webrtc
+{
+    using namespace ::webrtc;
+
+    // Value type of a serialized member. The order is the same as StatsMemberType in RTCStats.cs.
+    enum class StatsMemberType : uint8_t
+    {
+        Bool,
+        Int32,
+        Uint32,
+        Int64,
+        Uint64,
+        Double,
+        String,
+        SequenceBool,
+        SequenceInt32,
+        SequenceUint32,
+        SequenceInt64,
+        SequenceUint64,
+        SequenceDouble,
+        SequenceString,
+        MapStringUint64,
+        MapStringDouble
+    };
+
+    // Selects the stats and the members to serialize.
+    struct StatsReportFilter
+    {
+        // Types of the stats, as returned by RTCStats::type(). Every stats is selected if it is empty.
+        std::vector<std::string> types;
+        // Names of the members. Every member is selected if it is empty.
+        std::vector<std::string> members;
+    };
+
+    // Writes a whole RTCStatsReport into one contiguous buffer, so that the managed side reads it with a single call
+    // instead of allocating every id, name and value separately. Every string, including the member names which
+    // repeat in each stats of the same type, is stored once in a string table and referred to by its index.
+    //
+    // The buffer holds the following sections, each of them aligned to 8 bytes:
+    //   Header
+    //   StatsRecord[statsCount]
+    //   MemberRecord[memberCount], the members of each stats following each other
+    //   Data of the sequences and maps, each of them aligned to 8 bytes
+    //   StringEntry[stringCount]
+    //   Characters of the strings, each of them terminated with a null character
+    // Offsets in the records are relative to the start of their section.
+    class StatsReportSerializer
+    {
+    public:
+        static constexpr uint32_t kVersion = 2;
+        // Set in StatsRecord::flags when the stats of the previous report is not in the report any more.
+        static constexpr uint32_t kStatsRemoved = 1;
+
+        struct Header
+        {
+            uint32_t version;
+            uint32_t size;
+            uint32_t statsCount;
+            uint32_t statsOffset;
+            uint32_t memberCount;
+            uint32_t memberOffset;
+            uint32_t dataOffset;
+            uint32_t stringCount;
+            uint32_t stringOffset;
+            uint32_t charsOffset;
+        };
+
+        struct StatsRecord
+        {
+            uint32_t id;
+            uint32_t type;
+            int64_t timestamp;
+            uint32_t firstMember;
+            uint32_t memberCount;
+            uint32_t flags;
+            uint32_t reserved;
+        };
+
+        // A scalar is stored in the first bytes of |value|, and a string as its index. A sequence is stored at
+        // |offset| in the data section with |count| elements, as one byte per bool and as string indices of 32 bits
+        // for strings. A map is stored as the string indices of its |count| keys followed by its values, which start
+        // at the next multiple of 8 bytes.
+        struct MemberRecord
+        {
+            uint32_t name;
+            StatsMemberType type;
+            uint8_t defined;
+            uint16_t reserved;
+            uint32_t count;
+            uint32_t offset;
+            uint64_t value;
+        };
+
+        struct StringEntry
+        {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        StatsReportSerializer() = default;
+        StatsReportSerializer(const StatsReportSerializer&) = delete;
+        StatsReportSerializer& operator=(const StatsReportSerializer&) = delete;
+
+        // Serializes |report| and returns the size of the buffer. The report is only read during the call, and the
+        // result is kept until the next call.
+        size_t Serialize(const RTCStatsReport& report) { return Serialize(report, StatsReportFilter(), nullptr); }
+
+        // Serializes the stats and members of |report| selected by |filter|. If |previous| is not null, only the
+        // members which changed since the stats of the same id in |previous| are written, and the stats without any
+        // change are left out. The selected stats of |previous| which are not in |report| follow the other stats, as
+        // records flagged with kStatsRemoved and without any member.
+        size_t Serialize(const RTCStatsReport& report, const StatsReportFilter& filter, const RTCStatsReport* previous);
+
+        // Writes the last serialized report to |dst|, which must hold at least size() bytes.
+        void CopyTo(uint8_t* dst) const;
+
+        size_t size() const { return m_header.size; }
+
+    private:
+        void AddMember(const Attribute& attribute);
+        static bool Changed(const Attribute& attribute, const Attribute& previous);
+        // Strings are looked up by views into the report, so they are only interned while serializing it.
+        uint32_t Intern(std::string_view str);
+        uint32_t AppendData(const void* data, size_t size);
+
+        template<typename T>
+        void WriteValue(const T& value, MemberRecord* record);
+        void WriteValue(const std::string& value, MemberRecord* record);
+        template<typename T>
+        void WriteValue(const std::vector<T>& values, MemberRecord* record);
+        void WriteValue(const std::vector<bool>& values, MemberRecord* record);
+        void WriteValue(const std::vector<std::string>& values, MemberRecord* record);
+        template<typename T>
+        void WriteValue(const std::map<std::string, T>& values, MemberRecord* record);
+
+        std::vector<StatsRecord> m_stats;
+        std::vector<MemberRecord> m_members;
+        std::vector<uint8_t> m_data;
+        std::vector<StringEntry> m_strings;
+        std::vector<char> m_chars;
+        std::vector<uint32_t> m_indices;
+        std::unordered_map<std::string_view, uint32_t> m_stringIndices;
+        Header m_header = {};
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Mailbox which passes the latest value from one producer thread to one consumer thread without locking.
+    // Each side owns one of the three slots, and the third one holds the latest published value. Publishing and
+    // taking a value swap the owned slot with the shared one, so neither side waits for the other.
+    template<typename T>
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer() = default;
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Producer: the slot to fill before calling Publish.
+        T& back() { return m_slots[m_back]; }
+
+        // Producer: makes back() the latest value, and back() becomes another slot which may hold an old value.
+        // Returns true if the previous latest value was never taken by the consumer.
+        bool Publish()
+        {
+            const uint8_t published = static_cast<uint8_t>(m_back | kFresh);
+            const uint8_t previous = m_middle.exchange(published, std::memory_order_acq_rel);
+            m_back = previous & kIndexMask;
+            return (previous & kFresh) != 0;
+        }
+
+        // Consumer: takes the latest value if one has been published since the last call. Returns false and keeps
+        // front() otherwise.
+        bool Update()
+        {
+            // Only this thread clears the flag, so the value cannot be taken away after the check.
+            if ((m_middle.load(std::memory_order_relaxed) & kFresh) == 0)
+                return false;
+            const uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & kIndexMask;
+            return true;
+        }
+
+        // Consumer: the value taken by the last Update.
+        T& front() { return m_slots[m_front]; }
+
+    private:
+        static constexpr uint8_t kIndexMask = 0x3;
+        static constexpr uint8_t kFresh = 0x4;
+
+        std::array<T, 3> m_slots;
+        uint8_t m_back = 0;
+        uint8_t m_front = 1;
+        std::atomic<uint8_t> m_middle { 2 };
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <algorithm>
+
 #include <common_audio/include/audio_util.h>
 #include <rtc_base/ref_counted_object.h>
 
@@ -47,33 +49,62 @@ namespace webrtc
         RTC_DCHECK(nNumChannels);
         RTC_DCHECK(nNumFrames);
 
+        if (nNumChannels > kMaxNumChannels)
+        {
+            RTC_LOG(LS_WARNING) << "Audio with " << nNumChannels << " channels is not supported.";
+            return;
+        }
+
         std::lock_guard<std::mutex> lock(_mutex);
 
         // eg.  80 for 8KHz and 160 for 16kHz
         size_t nNumFramesFor10ms = static_cast<size_t>(nSampleRate / 100);
         size_t nNumSamplesFor10ms = nNumFramesFor10ms * nNumChannels;
+        size_t nNumSamples = nNumFrames * nNumChannels;
         constexpr size_t nBitPerSample = sizeof(int16_t) * 8;
 
-        if (_sampleRate != nSampleRate || _numChannels != nNumChannels || _numFrames != nNumFrames)
+        if (_sampleRate != nSampleRate || _numChannels != nNumChannels)
         {
+            // Samples of the previous format are dropped.
             _sampleRate = nSampleRate;
             _numChannels = nNumChannels;
-            _numFrames = nNumFrames;
-            _convertedAudioData.clear();
-            _convertedAudioData.reserve(nNumSamplesFor10ms * 20);
+            _ringBuffer.clear();
+            _ringReadPos = 0;
+            _ringSize = 0;
         }
 
-        for (size_t i = 0; i < nNumFrames; i++)
-            _convertedAudioData.push_back(::webrtc::FloatToS16(pAudioData[i]));
+        // Less than a chunk is left from the previous call, so the pushed samples and one more chunk are enough.
+        // The buffer is allocated again only when the format changes or the pushed data gets larger.
+        size_t numChunks = (nNumSamples + nNumSamplesFor10ms - 1) / nNumSamplesFor10ms + 1;
+        if (_ringBuffer.size() < numChunks * nNumSamplesFor10ms)
+            ResizeRingBuffer(numChunks * nNumSamplesFor10ms);
 
-        while (_convertedAudioData.size() >= nNumSamplesFor10ms)
+        const size_t capacity = _ringBuffer.size();
+        const size_t writePos = (_ringReadPos + _ringSize) % capacity;
+        const size_t firstLength = std::min(nNumSamples, capacity - writePos);
+        ::webrtc::FloatToS16(pAudioData, firstLength, _ringBuffer.data() + writePos);
+        ::webrtc::FloatToS16(pAudioData + firstLength, nNumSamples - firstLength, _ringBuffer.data());
+        _ringSize += nNumSamples;
+
+        while (_ringSize >= nNumSamplesFor10ms)
         {
+            const int16_t* chunk = _ringBuffer.data() + _ringReadPos;
             for (auto sink : _arrSink)
-                sink->OnData(_convertedAudioData.data(), nBitPerSample, nSampleRate, nNumChannels, nNumFramesFor10ms);
-            _convertedAudioData.erase(_convertedAudioData.begin(), _convertedAudioData.begin() + nNumSamplesFor10ms);
+                sink->OnData(chunk, nBitPerSample, nSampleRate, nNumChannels, nNumFramesFor10ms);
+            _ringReadPos = (_ringReadPos + nNumSamplesFor10ms) % capacity;
+            _ringSize -= nNumSamplesFor10ms;
         }
     }
 
+    void UnityAudioTrackSource::ResizeRingBuffer(size_t capacity)
+    {
+        // The remaining samples are less than a chunk, starting from a chunk boundary, so they are contiguous.
+        std::vector<int16_t> buffer(capacity);
+        std::copy_n(_ringBuffer.begin() + _ringReadPos, _ringSize, buffer.begin());
+        _ringBuffer.swap(buffer);
+        _ringReadPos = 0;
+    }
+
     UnityAudioTrackSource::UnityAudioTrackSource() { }
     UnityAudioTrackSource::UnityAudioTrackSource(const cricket::AudioOptions& audio_options)
         : _options(audio_options)
@@ -14,6 +14,9 @@ namespace webrtc
     class UnityAudioTrackSource : public LocalAudioSource
     {
     public:
+        // Largest channel count of the pushed audio, which is enough for 7.1.
+        static constexpr size_t kMaxNumChannels = 8;
+
         static rtc::scoped_refptr<UnityAudioTrackSource> Create();
         static rtc::scoped_refptr<UnityAudioTrackSource> Create(const cricket::AudioOptions& audio_options);
 
@@ -21,6 +24,8 @@ namespace webrtc
         void AddSink(AudioTrackSinkInterface* sink) override;
         void RemoveSink(AudioTrackSinkInterface* sink) override;
 
+        // |pAudioData| holds |nNumFrames| frames of |nNumChannels| interleaved samples. The samples are delivered to
+        // the sinks in 10 ms chunks, interleaved as they are.
         void PushAudioData(const float* pAudioData, int nSampleRate, size_t nNumChannels, size_t nNumFrames);
 
     protected:
@@ -30,13 +35,19 @@ namespace webrtc
         ~UnityAudioTrackSource() override;
 
     private:
-        std::vector<int16_t> _convertedAudioData;
+        void ResizeRingBuffer(size_t capacity);
+
+        // Converted samples waiting to be delivered in 10 ms chunks. The capacity is a multiple of the chunk size and
+        // chunks are read from multiples of the chunk size, so a chunk is never split by the end of the buffer and is
+        // passed to the sinks in place.
+        std::vector<int16_t> _ringBuffer;
+        size_t _ringReadPos = 0;
+        size_t _ringSize = 0;
         std::vector<AudioTrackSinkInterface*> _arrSink;
         std::mutex _mutex;
         cricket::AudioOptions _options;
         int _sampleRate = 0;
         size_t _numChannels = 0;
-        size_t _numFrames = 0;
     };
 } // end namespace webrtc
 } // end namespace unity
@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <api/task_queue/default_task_queue_factory.h>
+
 #include "Context.h"
 #include "GpuMemoryBufferPool.h"
 #include "GraphicsDevice/GraphicsDevice.h"
@@ -28,15 +30,25 @@ namespace webrtc
     static std::unique_ptr<UnityProfiler> s_UnityProfiler = nullptr;
     static std::unique_ptr<ProfilerMarkerFactory> s_ProfilerMarkerFactory = nullptr;
     static std::map<const uint32_t, std::shared_ptr<UnityVideoRenderer>> s_mapVideoRenderer;
+    // Renderers looked up by the last renderer batch event, used by the texture updates which follow it.
+    static std::map<const uint32_t, std::shared_ptr<UnityVideoRenderer>> s_batchVideoRenderers;
     static std::unique_ptr<Clock> s_clock;
 
-    static const size_t kLimitBufferCount = 20;
     static constexpr TimeDelta kStaleFrameLimit = TimeDelta::Seconds(10);
     static const UnityProfilerMarkerDesc* s_MarkerEncode = nullptr;
     static const UnityProfilerMarkerDesc* s_MarkerDecode = nullptr;
     static std::unique_ptr<IGraphicsDevice> s_gfxDevice;
     static std::unique_ptr<GpuMemoryBufferPool> s_bufferPool;
+    static GpuMemoryBufferPool::Budget s_bufferPoolBudget = GpuMemoryBufferPool::kDefaultBudget;
+    static GpuMemoryBufferPool::CpuReadback s_bufferPoolCpuReadback = GpuMemoryBufferPool::CpuReadback::Always;
+    static size_t s_conversionThreadCount = ConversionThreadPool::DefaultThreadCount();
     static int s_batchUpdateEventID = 0;
+    static int s_batchRendererUpdateEventID = 0;
+
+    // Captured frames are handed to the video sources on this queue so that the rendering thread only pays for
+    // submitting the texture copies.
+    static std::unique_ptr<TaskQueueFactory> s_taskQueueFactory;
+    static std::unique_ptr<TaskQueueBase, TaskQueueDeleter> s_frameDeliveryQueue;
 
     IGraphicsDevice* Plugin::GraphicsDevice() { return s_gfxDevice.get(); }
 
@@ -83,7 +95,8 @@ static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType ev
             break;
 
         // Reserve eventID range to use for custom plugin events.
-        s_batchUpdateEventID = s_UnityInterfaces->Get<IUnityGraphics>()->ReserveEventIDRange(1);
+        s_batchUpdateEventID = s_UnityInterfaces->Get<IUnityGraphics>()->ReserveEventIDRange(2);
+        s_batchRendererUpdateEventID = s_batchUpdateEventID + 1;
 
 #if defined(SUPPORT_VULKAN)
         if (renderer == kUnityGfxRendererVulkan)
@@ -114,16 +127,27 @@ static void UNITY_INTERFACE_API OnGraphicsDeviceEvent(UnityGfxDeviceEventType ev
         if (s_gfxDevice)
         {
             s_gfxDevice->InitV();
+            s_gfxDevice->GetConversionThreadPool()->SetThreadCount(s_conversionThreadCount);
         }
         s_bufferPool = std::make_unique<GpuMemoryBufferPool>(s_gfxDevice.get(), s_clock.get());
+        s_bufferPool->SetBudget(s_bufferPoolBudget);
+        s_bufferPool->SetCpuReadback(s_bufferPoolCpuReadback);
+        s_taskQueueFactory = CreateDefaultTaskQueueFactory();
+        s_frameDeliveryQueue =
+            s_taskQueueFactory->CreateTaskQueue("FrameDelivery", TaskQueueFactory::Priority::NORMAL);
         break;
     }
     case kUnityGfxDeviceEventShutdown:
     {
+        // Drop the frames waiting for delivery before the buffers are released.
+        s_frameDeliveryQueue = nullptr;
+        s_taskQueueFactory = nullptr;
+
         // Release buffers before graphics device because buffers depends on the device.
         s_bufferPool = nullptr;
 
         s_mapVideoRenderer.clear();
+        s_batchVideoRenderers.clear();
 
         if (s_gfxDevice)
         {
@@ -264,6 +288,8 @@ static void UNITY_INTERFACE_API OnBatchUpdateEvent(int eventID, void* data)
 
     if (!batchData || !batchData->tracks)
     {
+        s_batchVideoRenderers.clear();
+
         // Release all buffers.
         if (s_bufferPool)
             s_bufferPool->ReleaseStaleBuffers(Timestamp::PlusInfinity(), kStaleFrameLimit);
@@ -277,6 +303,11 @@ static void UNITY_INTERFACE_API OnBatchUpdateEvent(int eventID, void* data)
     if (!device->UpdateState())
         return;
 
+    // Copies of all tracks are submitted first, and the frames are delivered to the sources afterwards on the worker
+    // queue. Adapting a frame and passing it to the encoder no longer blocks the rendering thread.
+    std::vector<std::pair<rtc::scoped_refptr<UnityVideoTrackSource>, rtc::scoped_refptr<VideoFrame>>> frames;
+    frames.reserve(batchData->tracksCount);
+
     for (int i = 0; i < batchData->tracksCount; i++)
     {
         VideoStreamTrackData* trackData = batchData->tracks[i];
@@ -307,15 +338,18 @@ static void UNITY_INTERFACE_API OnBatchUpdateEvent(int eventID, void* data)
             }
             unity::webrtc::Size size(trackData->width, trackData->height);
 
-            if (s_bufferPool->bufferCount() < kLimitBufferCount)
-            {
-                std::unique_ptr<const ScopedProfiler> profiler;
-                if (s_ProfilerMarkerFactory)
-                    profiler = s_ProfilerMarkerFactory->CreateScopedProfiler(*s_MarkerEncode);
+            std::unique_ptr<const ScopedProfiler> profiler;
+            if (s_ProfilerMarkerFactory)
+                profiler = s_ProfilerMarkerFactory->CreateScopedProfiler(*s_MarkerEncode);
 
-                auto frame = s_bufferPool->CreateFrame(ptr, size, trackData->format, timestamp);
-                source->OnFrameCaptured(std::move(frame));
+            // The pool refuses the frame when the source or the whole pool is over the budget.
+            auto frame = s_bufferPool->CreateFrame(ptr, size, trackData->format, timestamp, source);
+            if (!frame)
+            {
+                source->OnFrameDropped();
+                continue;
             }
+            frames.emplace_back(source, std::move(frame));
         }
 #if 0
         else if (trackData->action == VideoStreamTrackAction::Decode)
@@ -329,6 +363,15 @@ static void UNITY_INTERFACE_API OnBatchUpdateEvent(int eventID, void* data)
 #endif
     }
 
+    if (!frames.empty())
+    {
+        // The task keeps references to the sources, so they stay alive even if they are removed before delivery.
+        s_frameDeliveryQueue->PostTask([frames = std::move(frames)]() mutable {
+            for (auto& pair : frames)
+                pair.first->OnFrameCaptured(std::move(pair.second));
+        });
+    }
+
     s_bufferPool->ReleaseStaleBuffers(timestamp, kStaleFrameLimit);
 }
 
@@ -341,8 +384,71 @@ GetBatchUpdateEventFunc(Context* context)
 
 extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetBatchUpdateEventID() { return s_batchUpdateEventID; }
 
-static void UNITY_INTERFACE_API TextureUpdateCallback(int eventID, void* data)
+extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
+GetBatchRendererUpdateEventFunc(Context* context)
+{
+    s_context = context;
+    return OnBatchRendererUpdateEvent;
+}
+
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API GetBatchRendererUpdateEventID()
+{
+    return s_batchRendererUpdateEventID;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
+SetGpuMemoryBufferPoolBudget(uint64_t maxBytes, uint32_t maxInFlightFramesPerSource)
+{
+    s_bufferPoolBudget = { static_cast<size_t>(maxBytes), maxInFlightFramesPerSource };
+    if (s_bufferPool)
+        s_bufferPool->SetBudget(s_bufferPoolBudget);
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetGpuMemoryBufferPoolCpuReadbackOnDemand(bool value)
+{
+    s_bufferPoolCpuReadback =
+        value ? GpuMemoryBufferPool::CpuReadback::OnDemand : GpuMemoryBufferPool::CpuReadback::Always;
+    if (s_bufferPool)
+        s_bufferPool->SetCpuReadback(s_bufferPoolCpuReadback);
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
+GetI420BufferPoolCounters(uint64_t* hitCount, uint64_t* missCount)
+{
+    IGraphicsDevice* device = Plugin::GraphicsDevice();
+    if (!device)
+    {
+        *hitCount = 0;
+        *missCount = 0;
+        return;
+    }
+    I420BufferPool* pool = device->GetI420BufferPool();
+    *hitCount = pool->hitCount();
+    *missCount = pool->missCount();
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API SetRGBToI420ConversionThreadCount(uint32_t threadCount)
 {
+    s_conversionThreadCount = threadCount;
+    IGraphicsDevice* device = Plugin::GraphicsDevice();
+    if (device)
+        device->GetConversionThreadPool()->SetThreadCount(s_conversionThreadCount);
+}
+
+// Keep in sync with Context.cs
+struct RendererBatchData
+{
+    int32_t renderersCount;
+    uint32_t* rendererIds;
+};
+
+// Looks up the renderers of all the texture updates which follow in one go, so the texture updates do not check the
+// context and take its lock one by one.
+static void UNITY_INTERFACE_API OnBatchRendererUpdateEvent(int eventID, void* data)
+{
+    if (eventID != s_batchRendererUpdateEventID)
+        return;
+    s_batchVideoRenderers.clear();
     if (!s_context)
         return;
     if (!ContextManager::GetInstance()->Exists(s_context))
@@ -351,13 +457,45 @@ static void UNITY_INTERFACE_API TextureUpdateCallback(int eventID, void* data)
     if (!lock.owns_lock())
         return;
 
+    RendererBatchData* batchData = static_cast<RendererBatchData*>(data);
+    if (!batchData || !batchData->rendererIds)
+        return;
+
+    for (int i = 0; i < batchData->renderersCount; i++)
+    {
+        uint32_t id = batchData->rendererIds[i];
+        auto renderer = s_context->GetVideoRenderer(id);
+        if (renderer)
+            s_batchVideoRenderers.emplace(id, std::move(renderer));
+    }
+}
+
+static std::shared_ptr<UnityVideoRenderer> GetVideoRendererForTextureUpdate(uint32_t id)
+{
+    // The renderer is kept alive by the batch, and the renderer itself is safe to use without the context lock.
+    auto it = s_batchVideoRenderers.find(id);
+    if (it != s_batchVideoRenderers.end())
+        return it->second;
+
+    if (!s_context)
+        return nullptr;
+    if (!ContextManager::GetInstance()->Exists(s_context))
+        return nullptr;
+    std::unique_lock<std::mutex> lock(s_context->mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return nullptr;
+    return s_context->GetVideoRenderer(id);
+}
+
+static void UNITY_INTERFACE_API TextureUpdateCallback(int eventID, void* data)
+{
     auto event = static_cast<UnityRenderingExtEventType>(eventID);
 
     if (event == kUnityRenderingExtEventUpdateTextureBeginV2)
     {
         auto params = reinterpret_cast<UnityRenderingExtTextureUpdateParamsV2*>(data);
 
-        auto renderer = s_context->GetVideoRenderer(params->userData);
+        auto renderer = GetVideoRendererForTextureUpdate(params->userData);
         if (renderer == nullptr)
             return;
         s_mapVideoRenderer[params->userData] = renderer;
@@ -375,7 +513,12 @@ static void UNITY_INTERFACE_API TextureUpdateCallback(int eventID, void* data)
     if (event == kUnityRenderingExtEventUpdateTextureEndV2)
     {
         auto params = reinterpret_cast<UnityRenderingExtTextureUpdateParamsV2*>(data);
-        s_mapVideoRenderer.erase(params->userData);
+        // The batch keeps the renderer only for its texture update, so a deleted renderer is neither kept alive nor
+        // found by a later update.
+        s_batchVideoRenderers.erase(params->userData);
+        // Nothing was sampled if the renderer was not found.
+        if (s_mapVideoRenderer.erase(params->userData) == 0)
+            return;
 
         if (s_UnityProfiler && s_UnityProfiler->IsAvailable())
             s_UnityProfiler->EndSample(s_MarkerDecode);
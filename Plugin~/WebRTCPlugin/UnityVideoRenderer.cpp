@@ -1,6 +1,11 @@
 #include "pch.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 #include <api/video/i420_buffer.h>
+#include <rtc_base/time_utils.h>
 
 #include "UnityVideoRenderer.h"
 
@@ -8,13 +13,30 @@ namespace unity
 {
 namespace webrtc
 {
+    constexpr TimeDelta kWaitIdleTimeout = TimeDelta::Seconds(5);
 
-    UnityVideoRenderer::UnityVideoRenderer(uint32_t id, DelegateVideoFrameResize callback, bool needFlipVertical)
+    UnityVideoRenderer::UnityVideoRenderer(
+        uint32_t id,
+        DelegateVideoFrameResize callback,
+        bool needFlipVertical,
+        std::shared_ptr<VideoRendererWorkerPool> workerPool)
         : m_id(id)
-        , m_last_renderered_timestamp(0)
-        , m_timestamp(0)
         , m_callback(callback)
         , m_needFlipVertical(needFlipVertical)
+        , m_receivedSequence(0)
+        , m_receivedWidth(0)
+        , m_receivedHeight(0)
+        , m_processRequests(0)
+        , m_layoutChanged(false)
+        , m_textureLayout(0)
+        , m_tempBufferSequence(0)
+        , m_tempBufferLayout(0)
+        , m_lastRenderedSequence(0)
+        , m_framesReceived(0)
+        , m_framesRendered(0)
+        , m_framesOverwritten(0)
+        , m_latencyHistogram {}
+        , m_workerPool(std::move(workerPool))
     {
         DebugLog("Create UnityVideoRenderer Id:%d", id);
     }
@@ -22,107 +44,224 @@ namespace webrtc
     UnityVideoRenderer::~UnityVideoRenderer()
     {
         DebugLog("Destroy UnityVideoRenderer Id:%d", m_id);
-        {
-            std::unique_lock<std::mutex> lock(m_mutex);
-        }
+
+        // Drops the posted processing and waits for the running conversion.
+        if (m_workerPool)
+            m_workerPool->CancelTasks(this);
     }
 
     void UnityVideoRenderer::OnFrame(const webrtc::VideoFrame& frame)
     {
-        rtc::scoped_refptr<webrtc::VideoFrameBuffer> frame_buffer = frame.video_frame_buffer();
-
-        if (frame_buffer->type() == webrtc::VideoFrameBuffer::Type::kNative)
-        {
-            frame_buffer = frame_buffer->ToI420();
-        }
-        SetFrameBuffer(frame_buffer, frame.timestamp_us());
+        // Native buffers are kept as they are. They are read back only when the render thread converts them for a
+        // texture update, which does not happen when they are replaced by a newer frame.
+        SetFrameBuffer(frame.video_frame_buffer());
+        PostProcessing();
     }
 
     uint32_t UnityVideoRenderer::GetId() { return m_id; }
 
     rtc::scoped_refptr<webrtc::VideoFrameBuffer> UnityVideoRenderer::GetFrameBuffer()
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        if (!lock.owns_lock())
-        {
-            return nullptr;
-        }
-        if (m_last_renderered_timestamp == m_timestamp)
+        ConvertedBuffer& latest = TakeLatestConvertedFrame();
+        if (!OnFrameRendered(latest))
         {
             // skipped copying texture
             return nullptr;
         }
-        m_last_renderered_timestamp = m_timestamp;
-        return m_frameBuffer;
+        return latest.frame;
     }
 
-    void UnityVideoRenderer::SetFrameBuffer(rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer, int64_t timestamp)
+    void UnityVideoRenderer::SetFrameBuffer(rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer)
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        if (!lock.owns_lock())
-        {
-            return;
-        }
         if (!buffer)
         {
             RTC_LOG(LS_INFO) << "The video buffer is already released.";
             return;
         }
 
-        if (m_frameBuffer == nullptr || m_frameBuffer->width() != buffer->width() ||
-            m_frameBuffer->height() != buffer->height())
+        // Called before the frame is published, so Unity resizes the texture before it can see the frame.
+        if (m_receivedWidth != buffer->width() || m_receivedHeight != buffer->height())
         {
+            m_receivedWidth = buffer->width();
+            m_receivedHeight = buffer->height();
             m_callback(this, buffer->width(), buffer->height());
         }
 
-        m_frameBuffer = buffer;
-        m_timestamp = timestamp;
+        m_framesReceived.fetch_add(1, std::memory_order_relaxed);
+
+        FrameSlot& slot = m_frames.back();
+        slot.buffer = std::move(buffer);
+        slot.sequence = ++m_receivedSequence;
+        slot.receivedTimeUs = rtc::TimeMicros();
+        m_frames.Publish();
+
+        // The slot given back holds a frame which is replaced or already taken, so it is released now rather than
+        // with the next frame.
+        m_frames.back().buffer = nullptr;
     }
 
     void* UnityVideoRenderer::ConvertVideoFrameToTextureAndWriteToBuffer(int width, int height, libyuv::FourCC format)
     {
-        auto frame = GetFrameBuffer();
+        const uint64_t layout = PackTextureLayout(width, height, format);
+        if (m_textureLayout.exchange(layout) != layout)
+        {
+            m_layoutChanged = true;
+            PostProcessing();
+        }
 
-        size_t size = static_cast<size_t>(width * height * 4);
-        if (tempBuffer.size() != size)
-            tempBuffer.resize(size);
+        ConvertedBuffer& latest = TakeLatestConvertedFrame();
+        if (latest.format == format && latest.width == width && latest.height == height)
+        {
+            OnFrameRendered(latest);
+            return latest.data.data();
+        }
 
-        // return a previous texture buffer when framebuffer is returned null.
-        if (!frame)
-            return tempBuffer.data();
+        // Nothing is converted for this layout yet, at the first update, after a resolution change, or for a native
+        // buffer. The latest frame is converted here, so Unity does not show an empty texture. The worker pool
+        // converts the next frames which are not native. Without a frame, Unity keeps the texture as it is.
+        if (!latest.frame)
+            return nullptr;
+        if (latest.sequence != m_tempBufferSequence || layout != m_tempBufferLayout)
+        {
+            size_t size = static_cast<size_t>(width * height * 4);
+            if (tempBuffer.size() != size)
+                tempBuffer.resize(size);
+            m_tempBufferSequence = 0;
+            if (!ConvertToBuffer(m_renderThreadConverter, latest.frame.get(), width, height, format, tempBuffer.data()))
+                return nullptr;
+            m_tempBufferSequence = latest.sequence;
+            m_tempBufferLayout = layout;
+        }
+        OnFrameRendered(latest);
+        return tempBuffer.data();
+    }
 
-        rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer = frame->ToI420();
-        if (!i420_buffer)
-            return tempBuffer.data();
+    bool UnityVideoRenderer::WaitIdleForTest()
+    {
+        const int64_t deadlineMs = rtc::TimeMillis() + kWaitIdleTimeout.ms();
+        while (m_processRequests.load() != 0)
+        {
+            if (rtc::TimeMillis() > deadlineMs)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    UnityVideoRenderer::Stats UnityVideoRenderer::GetStats()
+    {
+        Stats stats;
+        stats.framesReceived = m_framesReceived.load(std::memory_order_relaxed);
+        stats.framesRendered = m_framesRendered.load(std::memory_order_relaxed);
+        stats.framesOverwritten = m_framesOverwritten.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < kLatencyBucketCount; i++)
+            stats.latencyHistogram[i] = m_latencyHistogram[i].load(std::memory_order_relaxed);
+        return stats;
+    }
 
-        if (width != frame->width() || height != frame->height())
+    uint64_t UnityVideoRenderer::PackTextureLayout(int width, int height, uint32_t format)
+    {
+        return static_cast<uint64_t>(width & 0xffff) << 48 | static_cast<uint64_t>(height & 0xffff) << 32 | format;
+    }
+
+    bool UnityVideoRenderer::OnFrameRendered(const ConvertedBuffer& buffer)
+    {
+        if (!buffer.frame || buffer.sequence == m_lastRenderedSequence)
+            return false;
+
+        // Sequences are given in order of arrival, so the gap is the frames which were never rendered.
+        m_framesOverwritten.fetch_add(buffer.sequence - m_lastRenderedSequence - 1, std::memory_order_relaxed);
+        m_framesRendered.fetch_add(1, std::memory_order_relaxed);
+        m_lastRenderedSequence = buffer.sequence;
+
+        const int64_t latencyMs = (rtc::TimeMicros() - buffer.receivedTimeUs) / rtc::kNumMicrosecsPerMillisec;
+        auto bucket = std::lower_bound(kLatencyBucketBoundsMs.begin(), kLatencyBucketBoundsMs.end(), latencyMs);
+        m_latencyHistogram[bucket - kLatencyBucketBoundsMs.begin()].fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void UnityVideoRenderer::PostProcessing()
+    {
+        // Without the pool, the render thread processes the latest frame when it takes the converted one.
+        // A running task serves the requests made while it runs, so one task is enough.
+        if (!m_workerPool || m_processRequests.fetch_add(1) != 0)
+            return;
+        m_workerPool->PostTask(this, [this]() { RunProcessing(); });
+    }
+
+    void UnityVideoRenderer::RunProcessing()
+    {
+        uint32_t requests = m_processRequests.load();
+        while (true)
+        {
+            // Each run takes the latest frame, so it serves all the requests made before it.
+            ProcessLatestFrame();
+            const uint32_t remaining = m_processRequests.fetch_sub(requests) - requests;
+            if (remaining == 0)
+                return;
+            requests = remaining;
+        }
+    }
+
+    void UnityVideoRenderer::ProcessLatestFrame()
+    {
+        const bool layoutChanged = m_layoutChanged.exchange(false);
+        if (!m_frames.Update() && !layoutChanged)
+            return;
+
+        const FrameSlot& frame = m_frames.front();
+        if (!frame.buffer)
+            return;
+
+        ConvertedBuffer& converted = m_converted.back();
+        converted.frame = frame.buffer;
+        converted.sequence = frame.sequence;
+        converted.receivedTimeUs = frame.receivedTimeUs;
+        converted.format = 0;
+
+        // The texture layout is known after the first texture update. Native buffers are left to the render thread,
+        // which converts only the frame it takes, so the frames replaced before they are rendered are never read back.
+        const uint64_t layout = m_textureLayout.load();
+        if (layout != 0 && frame.buffer->type() != webrtc::VideoFrameBuffer::Type::kNative)
         {
-            auto temp = webrtc::I420Buffer::Create(width, height);
-            temp->ScaleFrom(*i420_buffer);
-            i420_buffer = temp;
+            const int width = static_cast<int>(layout >> 48);
+            const int height = static_cast<int>((layout >> 32) & 0xffff);
+            const uint32_t format = static_cast<uint32_t>(layout);
+            size_t size = static_cast<size_t>(width * height * 4);
+            if (converted.data.size() != size)
+                converted.data.resize(size);
+            if (ConvertToBuffer(m_converter, frame.buffer.get(), width, height, format, converted.data.data()))
+            {
+                converted.width = width;
+                converted.height = height;
+                converted.format = format;
+            }
         }
+        m_converted.Publish();
+        m_converted.back().frame = nullptr;
+    }
 
-        if (m_needFlipVertical)
-            height = -height;
-
-        int result = libyuv::ConvertFromI420(
-            i420_buffer->DataY(),
-            i420_buffer->StrideY(),
-            i420_buffer->DataU(),
-            i420_buffer->StrideU(),
-            i420_buffer->DataV(),
-            i420_buffer->StrideV(),
-            tempBuffer.data(),
-            0,
-            width,
-            height,
-            static_cast<uint32_t>(format));
-
-        if (result)
+    UnityVideoRenderer::ConvertedBuffer& UnityVideoRenderer::TakeLatestConvertedFrame()
+    {
+        if (!m_workerPool)
+            ProcessLatestFrame();
+        m_converted.Update();
+        return m_converted.front();
+    }
+
+    bool UnityVideoRenderer::ConvertToBuffer(
+        I420ToRGBConverter& converter, VideoFrameBuffer* frame, int width, int height, uint32_t format, uint8_t* dst)
+    {
+        rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer = frame->ToI420();
+        if (!i420_buffer)
+            return false;
+
+        if (!converter.Convert(*i420_buffer, width, height, format, m_needFlipVertical, dst))
         {
-            RTC_LOG(LS_INFO) << "libyuv::ConvertFromI420 failed. error:" << result;
+            RTC_LOG(LS_INFO) << "I420ToRGBConverter::Convert failed. format:" << format;
+            return false;
         }
-        return tempBuffer.data();
+        return true;
     }
 
 } // end namespace webrtc
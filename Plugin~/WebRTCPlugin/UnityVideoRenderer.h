@@ -1,11 +1,15 @@
 #pragma once
 
-#include <mutex>
+#include <array>
+#include <atomic>
 
 #include <api/video/video_frame.h>
 #include <api/video/video_sink_interface.h>
 #include <third_party/libyuv/include/libyuv.h>
 
+#include "I420ToRGBConverter.h"
+#include "TripleBuffer.h"
+#include "VideoRendererWorkerPool.h"
 #include "WebRTCPlugin.h"
 
 namespace unity
@@ -18,27 +22,132 @@ namespace webrtc
     class UnityVideoRenderer : public rtc::VideoSinkInterface<::webrtc::VideoFrame>
     {
     public:
-        UnityVideoRenderer(uint32_t id, DelegateVideoFrameResize callback, bool needFlipVertical);
+        // Upper bounds in milliseconds of the receive to render latency buckets. The last bucket has no bound.
+        static constexpr std::array<int64_t, 7> kLatencyBucketBoundsMs = { 5, 10, 20, 40, 80, 160, 320 };
+        static constexpr size_t kLatencyBucketCount = kLatencyBucketBoundsMs.size() + 1;
+
+        struct Stats
+        {
+            uint64_t framesReceived;
+            // Frames handed to Unity for the first time.
+            uint64_t framesRendered;
+            // Frames replaced by a newer one before they were rendered.
+            uint64_t framesOverwritten;
+            // Time from OnFrame until the frame is rendered.
+            std::array<uint64_t, kLatencyBucketCount> latencyHistogram;
+        };
+
+        // Received frames are converted to the texture layout on |workerPool|, so the render thread only hands the
+        // converted pixels to Unity. The pool is shared by the renderers of a context. Without the pool, frames are
+        // converted on the render thread. Frames are passed between the threads through triple buffers, so no thread
+        // waits for another one.
+        UnityVideoRenderer(
+            uint32_t id,
+            DelegateVideoFrameResize callback,
+            bool needFlipVertical,
+            std::shared_ptr<VideoRendererWorkerPool> workerPool = nullptr);
         ~UnityVideoRenderer() override;
+
+        // OnFrame and SetFrameBuffer must be called on one thread at a time.
         void OnFrame(const ::webrtc::VideoFrame& frame) override;
 
         uint32_t GetId();
+        // Returns the latest frame if it has not been returned or rendered yet.
+        // called on RenderThread
         rtc::scoped_refptr<VideoFrameBuffer> GetFrameBuffer();
-        void SetFrameBuffer(rtc::scoped_refptr<VideoFrameBuffer> buffer, int64_t timestamp);
+        void SetFrameBuffer(rtc::scoped_refptr<VideoFrameBuffer> buffer);
 
         // used in UnityRenderingExtEventUpdateTexture
         // called on RenderThread
+        // The returned buffer is not written until the next call on the render thread. Returns nullptr if no frame
+        // can be converted yet, so Unity skips the update.
         void* ConvertVideoFrameToTextureAndWriteToBuffer(int width, int height, libyuv::FourCC format);
 
+        // Waits until the frames received so far are converted.
+        bool WaitIdleForTest();
+
+        // Can be called on any thread.
+        Stats GetStats();
+
     private:
+        // Received frame, passed from OnFrame to the conversion.
+        struct FrameSlot
+        {
+            rtc::scoped_refptr<VideoFrameBuffer> buffer;
+            // Identifies the frame. Starts from 1.
+            uint64_t sequence = 0;
+            int64_t receivedTimeUs = 0;
+        };
+
+        // Frame converted to the texture layout, passed from the conversion to the render thread. |format| is 0 if
+        // the frame is not converted, because the texture layout was unknown.
+        struct ConvertedBuffer
+        {
+            std::vector<uint8_t> data;
+            int width = 0;
+            int height = 0;
+            uint32_t format = 0;
+            rtc::scoped_refptr<VideoFrameBuffer> frame;
+            uint64_t sequence = 0;
+            int64_t receivedTimeUs = 0;
+        };
+
+        static uint64_t PackTextureLayout(int width, int height, uint32_t format);
+
+        // Called on the render thread to count |buffer| as rendered. Frames skipped since the last rendered one are
+        // counted as overwritten. Returns false if the frame is empty or already rendered.
+        bool OnFrameRendered(const ConvertedBuffer& buffer);
+        // Makes the conversion take the latest frame. Without the worker pool, the render thread does it itself.
+        void PostProcessing();
+        // Called on the worker pool. Processes frames until no request is left, so a renderer runs on one worker at
+        // a time.
+        void RunProcessing();
+        // Called on the worker pool, or on the render thread without the pool.
+        void ProcessLatestFrame();
+        // Takes the latest converted frame on the render thread. The frame stays valid until the next call.
+        ConvertedBuffer& TakeLatestConvertedFrame();
+        bool ConvertToBuffer(
+            I420ToRGBConverter& converter,
+            VideoFrameBuffer* frame,
+            int width,
+            int height,
+            uint32_t format,
+            uint8_t* dst);
+
         uint32_t m_id;
-        std::mutex m_mutex;
-        std::vector<uint8_t> tempBuffer;
-        rtc::scoped_refptr<webrtc::VideoFrameBuffer> m_frameBuffer;
-        int64_t m_last_renderered_timestamp;
-        std::atomic<int64_t> m_timestamp;
         DelegateVideoFrameResize m_callback;
         bool m_needFlipVertical;
+
+        // Used by OnFrame.
+        uint64_t m_receivedSequence;
+        int m_receivedWidth;
+        int m_receivedHeight;
+        TripleBuffer<FrameSlot> m_frames;
+
+        // Used by the conversion.
+        TripleBuffer<ConvertedBuffer> m_converted;
+        I420ToRGBConverter m_converter;
+        // The number of processing requests not served yet. A task is posted when it becomes non-zero.
+        std::atomic<uint32_t> m_processRequests;
+        // Set when the texture layout changes, so the latest frame is converted again.
+        std::atomic<bool> m_layoutChanged;
+        // Layout of the texture given by the last texture update, packed by PackTextureLayout.
+        std::atomic<uint64_t> m_textureLayout;
+
+        // Used by the render thread.
+        // Holds the frame converted on the render thread, when nothing is converted for the texture layout yet.
+        std::vector<uint8_t> tempBuffer;
+        uint64_t m_tempBufferSequence;
+        uint64_t m_tempBufferLayout;
+        I420ToRGBConverter m_renderThreadConverter;
+        uint64_t m_lastRenderedSequence;
+
+        std::atomic<uint64_t> m_framesReceived;
+        std::atomic<uint64_t> m_framesRendered;
+        std::atomic<uint64_t> m_framesOverwritten;
+        std::array<std::atomic<uint64_t>, kLatencyBucketCount> m_latencyHistogram;
+
+        std::shared_ptr<VideoRendererWorkerPool> m_workerPool;
     };
 
 } // end namespace webrtc
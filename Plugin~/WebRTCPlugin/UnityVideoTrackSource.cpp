@@ -2,7 +2,6 @@
 
 #include "UnityVideoTrackSource.h"
 #include "VideoFrameAdapter.h"
-#include "VideoFrameScheduler.h"
 
 namespace unity
 {
@@ -21,6 +20,7 @@ namespace webrtc
         , is_screencast_(is_screencast)
         , frame_(nullptr)
         , syncApplicationFramerate_(true)
+        , droppedFrameCount_(0)
     {
         taskQueue_ = taskQueueFactory->CreateTaskQueue("VideoFrameScheduler", TaskQueueFactory::Priority::NORMAL);
         scheduler_ = std::make_unique<VideoFrameScheduler>(taskQueue_.get());
@@ -63,7 +63,10 @@ namespace webrtc
     void UnityVideoTrackSource::OnUpdateVideoFrame()
     {
         const std::unique_lock<std::mutex> lock(mutex_);
+        // No frame is captured if the application has not sent a new one since the last capture.
+        rtc::scoped_refptr<VideoFrame> frame = frame_;
         CaptureVideoFrame();
+        scheduler_->OnFrameCaptured(frame.get());
     }
 
     void UnityVideoTrackSource::CaptureVideoFrame()
@@ -119,5 +122,9 @@ namespace webrtc
         syncApplicationFramerate_ = value;
     }
 
+    void UnityVideoTrackSource::SetFramePacing(VideoFrameScheduler::Pacing pacing) { scheduler_->SetPacing(pacing); }
+
+    VideoFrameScheduler::Stats UnityVideoTrackSource::framePacingStats() const { return scheduler_->GetStats(); }
+
 } // end namespace webrtc
 } // end namespace unity
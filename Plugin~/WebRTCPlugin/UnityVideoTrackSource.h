@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 
 #include <absl/types/optional.h>
@@ -9,6 +10,7 @@
 #include <api/task_queue/task_queue_base.h>
 
 #include "VideoFrame.h"
+#include "VideoFrameScheduler.h"
 
 namespace unity
 {
@@ -21,7 +23,6 @@ namespace webrtc
     // the webrtc video pipeline, each received a media::VideoFrame is converted to
     // a webrtc::VideoFrame, taking any adaptation requested by downstream classes
     // into account.
-    class VideoFrameScheduler;
     class UnityVideoTrackSource : public rtc::AdaptedVideoTrackSource
     {
     public:
@@ -46,7 +47,13 @@ namespace webrtc
         absl::optional<bool> needs_denoising() const override;
         bool syncApplicationFramerate() const { return syncApplicationFramerate_; };
         void OnFrameCaptured(rtc::scoped_refptr<VideoFrame> frame);
+        // Called when a captured frame is discarded before reaching this source, e.g. over the buffer budget.
+        void OnFrameDropped() { droppedFrameCount_++; }
+        uint64_t droppedFrameCount() const { return droppedFrameCount_; }
         void SetSyncApplicationFramerate(bool value);
+        // Pacing of the captures when the application framerate is not synchronized.
+        void SetFramePacing(VideoFrameScheduler::Pacing pacing);
+        VideoFrameScheduler::Stats framePacingStats() const;
         using VideoTrackSourceInterface::AddOrUpdateSink;
         using VideoTrackSourceInterface::RemoveSink;
 
@@ -82,6 +89,7 @@ namespace webrtc
         std::unique_ptr<VideoFrameScheduler> scheduler_;
         rtc::scoped_refptr<unity::webrtc::VideoFrame> frame_;
         bool syncApplicationFramerate_;
+        std::atomic<uint64_t> droppedFrameCount_;
     };
 
 } // end namespace webrtc
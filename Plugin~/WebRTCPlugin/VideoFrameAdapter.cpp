@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <algorithm>
+
 #include <api/video/video_frame.h>
 
 #include "VideoFrameAdapter.h"
@@ -31,6 +33,7 @@ namespace webrtc
         , width_(width)
         , height_(height)
     {
+        parent_->AddRequestedSize(Size(width_, height_));
     }
 
     VideoFrameAdapter::ScaledBuffer::~ScaledBuffer() { }
@@ -39,19 +42,21 @@ namespace webrtc
 
     rtc::scoped_refptr<webrtc::I420BufferInterface> VideoFrameAdapter::ScaledBuffer::ToI420()
     {
-        return parent_->GetOrCreateFrameBufferForSize(Size(width_, height_))->ToI420();
+        auto buffer = parent_->GetOrCreateFrameBufferForSize(Size(width_, height_));
+        return buffer ? buffer->ToI420() : nullptr;
     }
 
     const I420BufferInterface* VideoFrameAdapter::ScaledBuffer::GetI420() const
     {
-        return parent_->GetOrCreateFrameBufferForSize(Size(width_, height_))->GetI420();
+        auto buffer = parent_->GetOrCreateFrameBufferForSize(Size(width_, height_));
+        return buffer ? buffer->GetI420() : nullptr;
     }
 
     rtc::scoped_refptr<VideoFrameBuffer>
     VideoFrameAdapter::ScaledBuffer::GetMappedFrameBuffer(rtc::ArrayView<VideoFrameBuffer::Type> types)
     {
         auto buffer = parent_->GetOrCreateFrameBufferForSize(Size(width_, height_));
-        return Contains(types, buffer->type()) ? buffer : nullptr;
+        return buffer && Contains(types, buffer->type()) ? buffer : nullptr;
     }
 
     rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::ScaledBuffer::CropAndScale(
@@ -81,12 +86,15 @@ namespace webrtc
 
     const I420BufferInterface* VideoFrameAdapter::GetI420() const
     {
-        return ConvertToVideoFrameBuffer(frame_)->GetI420();
+        // The buffer is null when the frame cannot be read on the CPU, and the encoder drops the frame.
+        rtc::scoped_refptr<I420BufferInterface> buffer = ConvertToVideoFrameBuffer(frame_);
+        return buffer ? buffer->GetI420() : nullptr;
     }
 
     rtc::scoped_refptr<I420BufferInterface> VideoFrameAdapter::ToI420()
     {
-        return ConvertToVideoFrameBuffer(frame_)->ToI420();
+        rtc::scoped_refptr<I420BufferInterface> buffer = ConvertToVideoFrameBuffer(frame_);
+        return buffer ? buffer->ToI420() : nullptr;
     }
 
     rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::CropAndScale(
@@ -96,21 +104,39 @@ namespace webrtc
             rtc::scoped_refptr<VideoFrameAdapter>(this), scaled_width, scaled_height);
     }
 
+    void VideoFrameAdapter::AddRequestedSize(const Size& size)
+    {
+        std::unique_lock<std::mutex> guard(scaleLock_);
+        if (scaledI420Buffers_.count({ size.width(), size.height() }))
+            return;
+        if (std::find(requestedSizes_.begin(), requestedSizes_.end(), size) == requestedSizes_.end())
+            requestedSizes_.push_back(size);
+    }
+
     rtc::scoped_refptr<VideoFrameBuffer> VideoFrameAdapter::GetOrCreateFrameBufferForSize(const Size& size)
     {
         std::unique_lock<std::mutex> guard(scaleLock_);
 
-        for (auto scaledI420buffer : scaledI40Buffers_)
+        auto found = scaledI420Buffers_.find({ size.width(), size.height() });
+        if (found != scaledI420Buffers_.end())
+            return found->second;
+
+        // Convert every layer requested so far from the RGB image in one readback.
+        std::vector<Size> sizes;
+        sizes.swap(requestedSizes_);
+        if (std::find(sizes.begin(), sizes.end(), size) == sizes.end())
+            sizes.push_back(size);
+
+        auto buffers = frame_->GetGpuMemoryBuffer()->ToScaledI420(sizes);
+        if (buffers.size() != sizes.size())
         {
-            Size bufferSize(scaledI420buffer->width(), scaledI420buffer->height());
-            if (size == bufferSize)
-            {
-                return scaledI420buffer;
-            }
+            // Keep the requests, so the next call converts every layer again.
+            requestedSizes_.swap(sizes);
+            return nullptr;
         }
-        auto buffer = VideoFrameBuffer::CropAndScale(0, 0, width(), height(), size.width(), size.height());
-        scaledI40Buffers_.push_back(buffer);
-        return buffer;
+        for (size_t i = 0; i < sizes.size(); i++)
+            scaledI420Buffers_[{ sizes[i].width(), sizes[i].height() }] = buffers[i];
+        return scaledI420Buffers_[{ size.width(), size.height() }];
     }
 
     rtc::scoped_refptr<I420BufferInterface>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <api/video/video_frame.h>
+#include <map>
 #include <vector>
 
 #include "VideoFrame.h"
@@ -73,13 +74,16 @@ namespace webrtc
         ~VideoFrameAdapter() override { }
 
     private:
+        // Sizes of the scaled buffers are collected so that all of them are converted at once.
+        void AddRequestedSize(const Size& size);
         rtc::scoped_refptr<webrtc::VideoFrameBuffer> GetOrCreateFrameBufferForSize(const Size& size);
         rtc::scoped_refptr<I420BufferInterface>
         ConvertToVideoFrameBuffer(rtc::scoped_refptr<VideoFrame> video_frame) const;
         // todo(kazuki):
         // Need this buffer because the type() method returns kI420.
         mutable rtc::scoped_refptr<I420BufferInterface> i420Buffer_;
-        std::vector<rtc::scoped_refptr<VideoFrameBuffer>> scaledI40Buffers_;
+        std::map<std::pair<int, int>, rtc::scoped_refptr<VideoFrameBuffer>> scaledI420Buffers_;
+        std::vector<Size> requestedSizes_;
         const rtc::scoped_refptr<VideoFrame> frame_;
         const Size size_;
         mutable std::mutex scaleLock_;
@@ -11,21 +11,33 @@ namespace webrtc
 {
     constexpr TimeDelta kTimeout = TimeDelta::Millis(1000);
 
+    // A slot is not missed and a frame is not late until it is behind by this part of the frame interval, so that
+    // task queue jitter does not skip a whole frame.
+    constexpr int kJitterToleranceDivisor = 4;
+
     VideoFrameScheduler::VideoFrameScheduler(TaskQueueBase* queue, Clock* clock)
         : maxFramerate_(30)
         , queue_(queue)
         , lastCaptureStartedTime_(Timestamp::Zero())
+        , nextCaptureTime_(Timestamp::Zero())
+        , captureSlotTime_(Timestamp::Zero())
         , clock_(clock)
     {
     }
 
     VideoFrameScheduler::~VideoFrameScheduler()
     {
+        if (queue_->IsCurrent())
+        {
+            task_.Stop();
+            return;
+        }
+
         rtc::Event done;
 
-        // Waiting for stopping task.
-        queue_->PostTask([task = std::move(task_), &done]() mutable {
-            task.Stop();
+        // Waiting for stopping task. Tasks posted by Pause run before this one.
+        queue_->PostTask([this, &done]() {
+            task_.Stop();
             done.Set();
         });
         done.Wait(kTimeout);
@@ -40,16 +52,63 @@ namespace webrtc
 
     void VideoFrameScheduler::Pause(bool pause)
     {
-        paused_ = pause;
-        if (!paused_)
+        // A running task stops by itself when it sees the flag.
+        if (paused_.exchange(pause) == pause || pause)
+            return;
+
+        if (queue_->IsCurrent())
         {
             StartRepeatingTask();
+            return;
         }
+        queue_->PostTask([this]() { StartRepeatingTask(); });
     }
 
-    void VideoFrameScheduler::OnFrameCaptured(const VideoFrame* frame) { }
+    void VideoFrameScheduler::OnFrameCaptured(const VideoFrame* frame)
+    {
+        if (!frame)
+            return;
+        framesCaptured_++;
 
-    void VideoFrameScheduler::SetMaxFramerateFps(int maxFramerate) { maxFramerate_ = maxFramerate; }
+        Timestamp now = clock_->CurrentTime();
+        lastCaptureLatencyUs_ = (now - lastCaptureStartedTime_).us();
+        const int maxFramerate = maxFramerate_.load();
+        if (maxFramerate != 0 && now - captureSlotTime_ > FrameInterval(maxFramerate) / kJitterToleranceDivisor)
+            framesLate_++;
+    }
+
+    void VideoFrameScheduler::SetMaxFramerateFps(int maxFramerate)
+    {
+        // The repeating task reads the new value when it schedules the next capture.
+        if (maxFramerate_.load(std::memory_order_relaxed) == maxFramerate)
+            return;
+        if (maxFramerate_.exchange(maxFramerate) != 0 || maxFramerate == 0)
+            return;
+
+        // The task does not schedule a capture while the framerate is 0, so it has to be started again.
+        if (queue_->IsCurrent())
+        {
+            RestartRepeatingTask();
+            return;
+        }
+        queue_->PostTask([this]() { RestartRepeatingTask(); });
+    }
+
+    void VideoFrameScheduler::SetPacing(Pacing pacing) { pacing_.store(pacing); }
+
+    VideoFrameScheduler::Stats VideoFrameScheduler::GetStats() const
+    {
+        return { framesScheduled_.load(),
+                 framesCaptured_.load(),
+                 framesLate_.load(),
+                 framesSkipped_.load(),
+                 TimeDelta::Micros(lastCaptureLatencyUs_.load()) };
+    }
+
+    TimeDelta VideoFrameScheduler::FrameInterval(int maxFramerate)
+    {
+        return std::max(TimeDelta::Seconds(1) / maxFramerate, TimeDelta::Millis(1));
+    }
 
     std::optional<TimeDelta> VideoFrameScheduler::ScheduleNextFrame()
     {
@@ -63,30 +122,58 @@ namespace webrtc
             return std::nullopt;
         }
 
-        if (maxFramerate_ == 0)
+        const int maxFramerate = maxFramerate_.load();
+        if (maxFramerate == 0)
         {
             return std::nullopt;
         }
 
         Timestamp now = clock_->CurrentTime();
-        TimeDelta interval = std::max(TimeDelta::Seconds(1) / maxFramerate_, TimeDelta::Millis(1));
-        Timestamp target_capture_time = std::max(lastCaptureStartedTime_ + interval, now);
-        return target_capture_time - now;
+        TimeDelta interval = FrameInterval(maxFramerate);
+        if (pacing_.load() == Pacing::Relative || timelineReset_)
+        {
+            timelineReset_ = false;
+            nextCaptureTime_ = std::max(lastCaptureStartedTime_ + interval, now);
+            return nextCaptureTime_ - now;
+        }
+
+        nextCaptureTime_ = captureSlotTime_ + interval;
+        TimeDelta tolerance = interval / kJitterToleranceDivisor;
+        if (now - nextCaptureTime_ > tolerance)
+        {
+            // Move to the first slot which can still be captured in time.
+            const int64_t behindUs = (now - tolerance - nextCaptureTime_).us();
+            const int64_t missed = (behindUs + interval.us() - 1) / interval.us();
+            nextCaptureTime_ += interval * missed;
+            framesSkipped_ += static_cast<uint64_t>(missed);
+        }
+        return std::max(nextCaptureTime_ - now, TimeDelta::Zero());
     }
 
     void VideoFrameScheduler::CaptureNextFrame()
     {
         lastCaptureStartedTime_ = clock_->CurrentTime();
+        captureSlotTime_ = nextCaptureTime_;
+        framesScheduled_++;
         callback_();
     }
 
+    void VideoFrameScheduler::RestartRepeatingTask()
+    {
+        task_.Stop();
+        StartRepeatingTask();
+    }
+
     void VideoFrameScheduler::StartRepeatingTask()
     {
-        RTC_DCHECK(!paused_);
-        RTC_DCHECK(!task_.Running());
+        // Pause may have been called again before this task ran, or the previous task has not seen the pause yet.
+        if (paused_ || task_.Running())
+            return;
 
+        timelineReset_ = true;
         auto firstDelay = ScheduleNextFrame();
-        RTC_DCHECK(firstDelay);
+        if (!firstDelay)
+            return;
 
         task_ = RepeatingTaskHandle::DelayedStart(queue_, firstDelay.value(), [this]() {
             if (paused_)
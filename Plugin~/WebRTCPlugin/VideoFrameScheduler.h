@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include <rtc_base/task_utils/repeating_task.h>
 
 #include "VideoFrame.h"
@@ -11,6 +13,28 @@ namespace webrtc
     class VideoFrameScheduler
     {
     public:
+        enum class Pacing
+        {
+            // The next capture is one interval after the previous capture started, so slow captures add up to drift.
+            Relative,
+            // Captures are scheduled on the timeline start + n * interval. Slots which have already passed are skipped
+            // instead of captured in a burst.
+            Absolute,
+        };
+
+        struct Stats
+        {
+            // Capture requests issued by the scheduler.
+            uint64_t framesScheduled;
+            // Capture requests which produced a frame.
+            uint64_t framesCaptured;
+            // Frames finished later than their slot allows.
+            uint64_t framesLate;
+            // Slots passed over because the scheduler woke up too late to use them.
+            uint64_t framesSkipped;
+            TimeDelta lastCaptureLatency;
+        };
+
         VideoFrameScheduler(TaskQueueBase* queue, Clock* clock = Clock::GetRealTimeClock());
         VideoFrameScheduler(const VideoFrameScheduler&) = delete;
         VideoFrameScheduler& operator=(const VideoFrameScheduler&) = delete;
@@ -21,7 +45,7 @@ namespace webrtc
         // frame should be captured.
         virtual void Start(std::function<void()> capture_callback);
 
-        // Pause and resumes the scheduler.
+        // Pause and resumes the scheduler. This method is thread safe.
         virtual void Pause(bool pause);
 
         // Called after |frame| has been captured. |frame| may be set to nullptr
@@ -29,22 +53,44 @@ namespace webrtc
         virtual void OnFrameCaptured(const VideoFrame* frame);
 
         // Called when WebRTC requests the VideoTrackSource to provide frames
-        // at a maximum framerate.
+        // at a maximum framerate. This method is thread safe and only stores
+        // the value when it changes, so it can be called for every frame.
+        // A framerate of 0 stops the captures until a positive one is set.
         virtual void SetMaxFramerateFps(int maxFramerate);
 
+        // This method is thread safe.
+        void SetPacing(Pacing pacing);
+        Stats GetStats() const;
+
     private:
         std::optional<TimeDelta> ScheduleNextFrame();
+        static TimeDelta FrameInterval(int maxFramerate);
         void CaptureNextFrame();
         void StartRepeatingTask();
+        void RestartRepeatingTask();
         void StopTask();
 
         std::function<void()> callback_;
-        bool paused_ = false;
-        int maxFramerate_;
+        // Control state written from any thread and read by the task on |queue_|.
+        std::atomic<bool> paused_ { false };
+        std::atomic<int> maxFramerate_;
+        std::atomic<Pacing> pacing_ { Pacing::Relative };
+        // The members below are used only on |queue_|, except in Start which runs before the task.
         RepeatingTaskHandle task_;
         TaskQueueBase* queue_;
         Timestamp lastCaptureStartedTime_;
+        // Slot of the capture which is requested next, and of the one in progress.
+        Timestamp nextCaptureTime_;
+        Timestamp captureSlotTime_;
+        // Set when the task starts, so the time spent paused is not counted as skipped slots.
+        bool timelineReset_ = true;
         Clock* clock_;
+
+        std::atomic<uint64_t> framesScheduled_ { 0 };
+        std::atomic<uint64_t> framesCaptured_ { 0 };
+        std::atomic<uint64_t> framesLate_ { 0 };
+        std::atomic<uint64_t> framesSkipped_ { 0 };
+        std::atomic<int64_t> lastCaptureLatencyUs_ { 0 };
     };
 }
 }
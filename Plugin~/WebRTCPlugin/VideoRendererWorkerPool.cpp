@@ -0,0 +1,75 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "VideoRendererWorkerPool.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    VideoRendererWorkerPool::VideoRendererWorkerPool(size_t threadCount)
+        : m_running(std::max<size_t>(threadCount, 1), nullptr)
+        , m_quit(false)
+    {
+        for (size_t i = 0; i < m_running.size(); i++)
+            m_threads.emplace_back(&VideoRendererWorkerPool::Run, this, i);
+    }
+
+    VideoRendererWorkerPool::~VideoRendererWorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+            m_queue.clear();
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    void VideoRendererWorkerPool::PostTask(const void* owner, std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back({ owner, std::move(task) });
+        }
+        m_condition.notify_one();
+    }
+
+    void VideoRendererWorkerPool::CancelTasks(const void* owner)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queue.erase(
+            std::remove_if(m_queue.begin(), m_queue.end(), [owner](const Task& task) { return task.owner == owner; }),
+            m_queue.end());
+        m_finished.wait(
+            lock, [this, owner] { return std::find(m_running.begin(), m_running.end(), owner) == m_running.end(); });
+    }
+
+    void VideoRendererWorkerPool::Run(size_t index)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_condition.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+            if (m_quit)
+                return;
+
+            Task task = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_running[index] = task.owner;
+
+            lock.unlock();
+            task.run();
+            // Released before the owner can see the task finished.
+            task.run = nullptr;
+            lock.lock();
+
+            m_running[index] = nullptr;
+            m_finished.notify_all();
+        }
+    }
+
+} // end namespace webrtc
+} // end namespace unity
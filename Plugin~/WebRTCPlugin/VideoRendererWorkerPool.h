@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Worker threads shared by all video renderers of a context, so the number of threads does not grow with the
+    // number of remote streams. Each task belongs to an owner, which cancels its tasks before it is destroyed.
+    // This class is thread safe.
+    class VideoRendererWorkerPool
+    {
+    public:
+        explicit VideoRendererWorkerPool(size_t threadCount);
+        VideoRendererWorkerPool(const VideoRendererWorkerPool&) = delete;
+        VideoRendererWorkerPool& operator=(const VideoRendererWorkerPool&) = delete;
+        // Drops the tasks which are not started yet.
+        ~VideoRendererWorkerPool();
+
+        void PostTask(const void* owner, std::function<void()> task);
+
+        // Drops the tasks of |owner| which are not started yet, and waits for the running one.
+        void CancelTasks(const void* owner);
+
+    private:
+        struct Task
+        {
+            const void* owner;
+            std::function<void()> run;
+        };
+
+        void Run(size_t index);
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_finished;
+        std::deque<Task> m_queue;
+        // The owner of the task each thread is running, or null.
+        std::vector<const void*> m_running;
+        std::vector<std::thread> m_threads;
+        bool m_quit;
+    };
+
+} // end namespace webrtc
+} // end namespace unity
@@ -1,5 +1,7 @@
 #include "pch.h"
 
+#include <algorithm>
+
 #include "Context.h"
 #include "CreateSessionDescriptionObserver.h"
 #include "EncodedStreamTransformer.h"
@@ -423,6 +425,32 @@ extern "C"
         context->DeleteVideoRenderer(sink);
     }
 
+    // Copies at most |bucketCount| buckets of the latency histogram and returns the number of buckets.
+    UNITY_INTERFACE_EXPORT int32_t VideoRendererGetStats(
+        UnityVideoRenderer* sink,
+        uint64_t* framesReceived,
+        uint64_t* framesRendered,
+        uint64_t* framesOverwritten,
+        uint64_t* latencyHistogram,
+        int32_t bucketCount)
+    {
+        UnityVideoRenderer::Stats stats = sink->GetStats();
+        *framesReceived = stats.framesReceived;
+        *framesRendered = stats.framesRendered;
+        *framesOverwritten = stats.framesOverwritten;
+        const size_t count = std::min(static_cast<size_t>(std::max(bucketCount, 0)), stats.latencyHistogram.size());
+        std::copy_n(stats.latencyHistogram.begin(), count, latencyHistogram);
+        return static_cast<int32_t>(stats.latencyHistogram.size());
+    }
+
+    // Writes at most |count| upper bounds in milliseconds of the latency buckets and returns the number of bounds.
+    UNITY_INTERFACE_EXPORT int32_t VideoRendererGetLatencyBucketBounds(int64_t* boundsMs, int32_t count)
+    {
+        const auto& bounds = UnityVideoRenderer::kLatencyBucketBoundsMs;
+        std::copy_n(bounds.begin(), std::min(static_cast<size_t>(std::max(count, 0)), bounds.size()), boundsMs);
+        return static_cast<int32_t>(bounds.size());
+    }
+
     UNITY_INTERFACE_EXPORT void VideoTrackAddOrUpdateSink(VideoTrackInterface* track, UnityVideoRenderer* sink)
     {
         track->AddOrUpdateSink(sink, rtc::VideoSinkWants());
@@ -658,6 +686,36 @@ extern "C"
         return context->GetStatsList(report, length, types);
     }
 
+    UNITY_INTERFACE_EXPORT size_t
+    ContextSerializeStatsReport(Context* context, const RTCStatsReport* report, uint8_t* buffer, size_t capacity)
+    {
+        return context->SerializeStatsReport(report, nullptr, StatsReportFilter(), buffer, capacity);
+    }
+
+    UNITY_INTERFACE_EXPORT size_t ContextSerializeStatsReportFiltered(
+        Context* context,
+        const RTCStatsReport* report,
+        const RTCStatsReport* previous,
+        const uint32_t* types,
+        size_t typesLength,
+        const char** members,
+        size_t membersLength,
+        uint8_t* buffer,
+        size_t capacity)
+    {
+        StatsReportFilter filter;
+        for (size_t i = 0; i < typesLength; i++)
+        {
+            if (const char* type = GetStatsTypeName(types[i]))
+                filter.types.push_back(type);
+        }
+        // Types which are all unknown select no stats rather than every stats.
+        if (typesLength > 0 && filter.types.empty())
+            filter.types.push_back(std::string());
+        filter.members.assign(members, members + membersLength);
+        return context->SerializeStatsReport(report, previous, filter, buffer, capacity);
+    }
+
     UNITY_INTERFACE_EXPORT void ContextDeleteStatsReport(Context* context, const RTCStatsReport* report)
     {
         context->DeleteStatsReport(report);
@@ -669,7 +727,7 @@ extern "C"
 
     UNITY_INTERFACE_EXPORT const char* StatsGetId(const RTCStats* stats) { return ConvertString(stats->id()); }
 
-    UNITY_INTERFACE_EXPORT uint32_t StatsGetType(const RTCStats* stats) { return statsTypes.at(stats->type()); }
+    UNITY_INTERFACE_EXPORT uint32_t StatsGetType(const RTCStats* stats) { return GetStatsTypeId(stats->type()); }
 
     UNITY_INTERFACE_EXPORT const Attribute* StatsGetMembers(const RTCStats* stats, size_t* length)
     {
@@ -1390,6 +1448,32 @@ extern "C"
         source->SetSyncApplicationFramerate(value);
     }
 
+    UNITY_INTERFACE_EXPORT uint64_t VideoSourceGetDroppedFrameCount(UnityVideoTrackSource* source)
+    {
+        return source->droppedFrameCount();
+    }
+
+    UNITY_INTERFACE_EXPORT void VideoSourceSetAbsoluteFramePacing(UnityVideoTrackSource* source, bool value)
+    {
+        source->SetFramePacing(value ? VideoFrameScheduler::Pacing::Absolute : VideoFrameScheduler::Pacing::Relative);
+    }
+
+    UNITY_INTERFACE_EXPORT void VideoSourceGetFramePacingStats(
+        UnityVideoTrackSource* source,
+        uint64_t* framesScheduled,
+        uint64_t* framesCaptured,
+        uint64_t* framesLate,
+        uint64_t* framesSkipped,
+        int64_t* lastCaptureLatencyUs)
+    {
+        VideoFrameScheduler::Stats stats = source->framePacingStats();
+        *framesScheduled = stats.framesScheduled;
+        *framesCaptured = stats.framesCaptured;
+        *framesLate = stats.framesLate;
+        *framesSkipped = stats.framesSkipped;
+        *lastCaptureLatencyUs = stats.lastCaptureLatency.us();
+    }
+
     struct RTCRtpHeaderExtensionCapability
     {
         char* uri;
@@ -1541,7 +1625,7 @@ extern "C"
 
     UNITY_INTERFACE_EXPORT void DataChannelSend(DataChannelInterface* channel, const char* data)
     {
-        channel->Send(webrtc::DataBuffer(std::string(data)));
+        channel->Send(webrtc::DataBuffer(rtc::CopyOnWriteBuffer(data, std::strlen(data)), false));
     }
 
     UNITY_INTERFACE_EXPORT void DataChannelSendBinary(DataChannelInterface* channel, const byte* data, int length)
@@ -1550,6 +1634,15 @@ extern "C"
         channel->Send(webrtc::DataBuffer(buf, true));
     }
 
+    UNITY_INTERFACE_EXPORT int32_t DataChannelSendBatch(
+        Context* context, DataChannelInterface* channel, const DataChannelSpan* messages, int32_t count)
+    {
+        DataChannelObject* object = context->GetDataChannelObject(channel);
+        if (object == nullptr || messages == nullptr || count <= 0)
+            return 0;
+        return static_cast<int32_t>(object->SendBatch(messages, static_cast<size_t>(count)));
+    }
+
     UNITY_INTERFACE_EXPORT void DataChannelClose(DataChannelInterface* channel) { channel->Close(); }
 
     UNITY_INTERFACE_EXPORT void
@@ -1576,6 +1669,46 @@ extern "C"
         context->GetDataChannelObject(channel)->RegisterOnError(callback);
     }
 
+    UNITY_INTERFACE_EXPORT void DataChannelRegisterOnBufferedAmountLow(
+        Context* context, DataChannelInterface* channel, DelegateOnBufferedAmountLow callback)
+    {
+        if (DataChannelObject* object = context->GetDataChannelObject(channel))
+            object->RegisterOnBufferedAmountLow(callback);
+    }
+
+    UNITY_INTERFACE_EXPORT void
+    DataChannelSetBufferedAmountLowThreshold(Context* context, DataChannelInterface* channel, uint64_t threshold)
+    {
+        if (DataChannelObject* object = context->GetDataChannelObject(channel))
+            object->SetBufferedAmountLowThreshold(threshold);
+    }
+
+    // Returns the handle which DataChannelReceiveMessages and DataChannelReleaseMessages take, so the context is not
+    // looked up for every batch of messages. The handle is valid until the channel is deleted.
+    UNITY_INTERFACE_EXPORT DataChannelObject*
+    DataChannelSetQueuedDelivery(Context* context, DataChannelInterface* channel, bool enabled)
+    {
+        DataChannelObject* object = context->GetDataChannelObject(channel);
+        if (object == nullptr)
+            return nullptr;
+        object->SetQueuedDelivery(enabled);
+        return object;
+    }
+
+    UNITY_INTERFACE_EXPORT int32_t
+    DataChannelReceiveMessages(DataChannelObject* object, DataChannelMessageView* views, int32_t capacity)
+    {
+        if (object == nullptr || views == nullptr || capacity <= 0)
+            return 0;
+        return static_cast<int32_t>(object->ReceiveMessages(views, static_cast<size_t>(capacity)));
+    }
+
+    UNITY_INTERFACE_EXPORT void DataChannelReleaseMessages(DataChannelObject* object)
+    {
+        if (object != nullptr)
+            object->ReleaseMessages();
+    }
+
     UNITY_INTERFACE_EXPORT void SetCurrentContext(Context* context)
     {
         ContextManager::GetInstance()->curContext = context;
@@ -1624,6 +1757,29 @@ extern "C"
         sink->ProcessAudio(data, length, static_cast<size_t>(channels), sampleRate);
     }
 
+    UNITY_INTERFACE_EXPORT void AudioTrackSinkSetDriftCorrection(AudioTrackSinkAdapter* sink, bool enabled)
+    {
+        sink->SetDriftCorrection(enabled);
+    }
+
+    UNITY_INTERFACE_EXPORT void AudioTrackSinkGetStats(
+        AudioTrackSinkAdapter* sink,
+        uint64_t* underruns,
+        uint64_t* overruns,
+        uint64_t* droppedFrames,
+        uint64_t* insertedFrames,
+        int32_t* bufferedMs,
+        int32_t* targetMs)
+    {
+        AudioTrackSinkAdapter::Stats stats = sink->GetStats();
+        *underruns = stats.underruns;
+        *overruns = stats.overruns;
+        *droppedFrames = stats.droppedFrames;
+        *insertedFrames = stats.insertedFrames;
+        *bufferedMs = stats.bufferedMs;
+        *targetMs = stats.targetMs;
+    }
+
     UNITY_INTERFACE_EXPORT uint32_t FrameGetTimestamp(TransformableFrameInterface* frame)
     {
         return frame->GetTimestamp();
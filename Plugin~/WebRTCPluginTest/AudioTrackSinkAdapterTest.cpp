@@ -0,0 +1,199 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <rtc_base/time_utils.h>
+
+#include "AudioTrackSinkAdapter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace
+    {
+        // Samples count from 1 to 32767 and start again, so 0 only comes from the silence of an empty buffer.
+        int16_t SampleAt(size_t index) { return static_cast<int16_t>(index % 32767 + 1); }
+
+        // Pushes |count| chunks of 10 ms of 48 kHz stereo, continuing the samples from |*produced|.
+        void PushChunks(AudioTrackSinkAdapter* adapter, int count, size_t* produced)
+        {
+            std::vector<int16_t> chunk(960);
+            for (int n = 0; n < count; n++)
+            {
+                for (size_t i = 0; i < chunk.size(); i++)
+                    chunk[i] = SampleAt(*produced + i);
+                adapter->OnData(chunk.data(), 16, 48000, 2, 480);
+                *produced += chunk.size();
+            }
+        }
+    }
+
+    TEST(AudioTrackSinkAdapterTest, ReturnSilenceUntilFormatIsApplied)
+    {
+        AudioTrackSinkAdapter adapter;
+        std::vector<float> data(1024, 1.0f);
+        adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+        for (float sample : data)
+            ASSERT_EQ(0.0f, sample);
+
+        // The audio is played once the target of 40 ms is buffered.
+        size_t produced = 0;
+        PushChunks(&adapter, 3, &produced);
+        adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+        for (float sample : data)
+            ASSERT_EQ(0.0f, sample);
+        PushChunks(&adapter, 2, &produced);
+
+        adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+        for (size_t i = 0; i < data.size(); i++)
+            ASSERT_EQ(SampleAt(i), static_cast<int16_t>(std::lround(data[i] * 32768.0f))) << "at " << i;
+    }
+
+    TEST(AudioTrackSinkAdapterTest, CountUnderrunsAndOverruns)
+    {
+        AudioTrackSinkAdapter adapter;
+        std::vector<float> data(1024);
+        adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+
+        // 50 ms lasts for four reads of 512 frames.
+        size_t produced = 0;
+        PushChunks(&adapter, 5, &produced);
+        for (int i = 0; i < 5; i++)
+            adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+        AudioTrackSinkAdapter::Stats stats = adapter.GetStats();
+        EXPECT_EQ(1u, stats.underruns);
+        EXPECT_EQ(0u, stats.overruns);
+        EXPECT_EQ(AudioTrackSinkAdapter::kMinTargetMs + AudioTrackSinkAdapter::kTargetStepUpMs, stats.targetMs);
+
+        // The buffer holds 200 ms.
+        PushChunks(&adapter, 25, &produced);
+        stats = adapter.GetStats();
+        EXPECT_EQ(5u, stats.overruns);
+    }
+
+    TEST(AudioTrackSinkAdapterTest, InsertFramesWhenBufferedAudioIsBelowTarget)
+    {
+        AudioTrackSinkAdapter adapter;
+        adapter.SetDriftCorrection(true);
+        // Reads of 20 ms, below the target of 40 ms minus the tolerance of 10 ms.
+        std::vector<float> data(1920);
+        adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+
+        size_t produced = 0;
+        PushChunks(&adapter, 4, &produced);
+        adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+
+        // 20 ms is buffered before each read, so the average follows it down and crosses the threshold at the 11th.
+        for (int i = 1; i <= 15; i++)
+        {
+            adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+            PushChunks(&adapter, 2, &produced);
+        }
+        AudioTrackSinkAdapter::Stats stats = adapter.GetStats();
+        EXPECT_EQ(5u, stats.insertedFrames);
+        EXPECT_EQ(0u, stats.droppedFrames);
+        EXPECT_EQ(0u, stats.underruns);
+
+        // The reads with an inserted frame take one frame less, and repeat the last frame at the end.
+        const size_t start = 11 * 1920 + 4 * 1918;
+        EXPECT_EQ(SampleAt(start), static_cast<int16_t>(std::lround(data[0] * 32768.0f)));
+        EXPECT_EQ(SampleAt(start + 1917), static_cast<int16_t>(std::lround(data[1917] * 32768.0f)));
+        EXPECT_EQ(data[1916], data[1918]);
+        EXPECT_EQ(data[1917], data[1919]);
+    }
+
+    TEST(AudioTrackSinkAdapterTest, DrainTowardTargetWithoutDriftCorrection)
+    {
+        AudioTrackSinkAdapter adapter;
+        std::vector<float> data(1024);
+        adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+
+        size_t produced = 0;
+        PushChunks(&adapter, 15, &produced);
+        for (int i = 0; i < 5; i++)
+            adapter.ProcessAudio(data.data(), data.size(), 2, 48000);
+
+        // The buffered audio is drained even though the drift correction is disabled by default.
+        AudioTrackSinkAdapter::Stats stats = adapter.GetStats();
+        EXPECT_EQ(5u, stats.droppedFrames);
+        EXPECT_EQ(0u, stats.insertedFrames);
+        EXPECT_EQ(SampleAt(4 * 1024 + 5 * 2), static_cast<int16_t>(std::lround(data[0] * 32768.0f)));
+    }
+
+    // OnData and ProcessAudio run on their own threads at the same time, like the WebRTC and the Unity audio threads.
+    TEST(AudioTrackSinkAdapterTest, NoSampleLostOrDuplicatedBetweenThreads)
+    {
+        const int kSampleRate = 48000;
+        const size_t kChannels = 2;
+        const size_t kChunkSamples = kSampleRate / 100 * kChannels;
+        const size_t kReadSamples = 1024 * kChannels;
+        const size_t kTotalSamples = kChunkSamples * 2000;
+        // More than the largest target, which ProcessAudio waits for after an underrun, and less than the buffer of
+        // 0.2 seconds, so the producer never drops samples.
+        const size_t kMaxBufferedSamples = kChunkSamples * 18;
+
+        AudioTrackSinkAdapter adapter;
+        std::vector<float> data(kReadSamples);
+        // The first call requests the format.
+        adapter.ProcessAudio(data.data(), data.size(), kChannels, kSampleRate);
+
+        std::atomic<size_t> consumed(0);
+        std::atomic<bool> consuming(true);
+        std::thread producer(
+            [&]()
+            {
+                std::vector<int16_t> chunk(kChunkSamples);
+                // Continues after the checked samples, so the consumer is not left waiting for the target.
+                for (size_t produced = 0; consuming; produced += kChunkSamples)
+                {
+                    while (produced - consumed.load() > kMaxBufferedSamples && consuming)
+                        std::this_thread::yield();
+                    for (size_t i = 0; i < kChunkSamples; i++)
+                        chunk[i] = SampleAt(produced + i);
+                    adapter.OnData(chunk.data(), 16, kSampleRate, kChannels, kChunkSamples / kChannels);
+                }
+            });
+
+        size_t mismatches = 0;
+        std::thread consumer(
+            [&]()
+            {
+                const int64_t deadline = rtc::TimeMillis() + 30000;
+                size_t received = 0;
+                uint64_t droppedFrames = 0;
+                while (received < kTotalSamples && rtc::TimeMillis() < deadline)
+                {
+                    adapter.ProcessAudio(data.data(), data.size(), kChannels, kSampleRate);
+                    // Frames drained above the target are dropped before the read, so they are skipped.
+                    const uint64_t dropped = adapter.GetStats().droppedFrames;
+                    const size_t skipped = static_cast<size_t>(dropped - droppedFrames) * kChannels;
+                    received = std::min(kTotalSamples, received + skipped);
+                    droppedFrames = dropped;
+                    for (float value : data)
+                    {
+                        const int16_t sample = static_cast<int16_t>(std::lround(value * 32768.0f));
+                        // Silence fills the rest of the buffer when nothing more is buffered.
+                        if (sample == 0 || received == kTotalSamples)
+                            continue;
+                        if (sample != SampleAt(received))
+                            mismatches++;
+                        received++;
+                    }
+                    consumed = received;
+                }
+                consuming = false;
+            });
+        producer.join();
+        consumer.join();
+
+        EXPECT_EQ(kTotalSamples, consumed.load());
+        EXPECT_EQ(0u, mismatches);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
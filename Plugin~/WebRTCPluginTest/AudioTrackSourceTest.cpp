@@ -0,0 +1,236 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <common_audio/include/audio_util.h>
+#include <rtc_base/time_utils.h>
+
+#include "Benchmark.h"
+#include "UnityAudioTrackSource.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace
+    {
+        // Sink which keeps the samples it receives.
+        class FakeAudioSink : public AudioTrackSinkInterface
+        {
+        public:
+            void OnData(
+                const void* audio_data,
+                int bits_per_sample,
+                int sample_rate,
+                size_t number_of_channels,
+                size_t number_of_frames) override
+            {
+                EXPECT_EQ(16, bits_per_sample);
+                EXPECT_EQ(static_cast<size_t>(sample_rate / 100), number_of_frames);
+                const int16_t* data = static_cast<const int16_t*>(audio_data);
+                samples.insert(samples.end(), data, data + number_of_frames * number_of_channels);
+                channels = number_of_channels;
+                chunkCount++;
+            }
+            std::vector<int16_t> samples;
+            size_t channels = 0;
+            int chunkCount = 0;
+        };
+
+        // Sink which only counts the chunks, so the benchmark measures the source.
+        class CountingAudioSink : public AudioTrackSinkInterface
+        {
+        public:
+            void OnData(const void*, int, int, size_t, size_t) override { chunkCount++; }
+            int chunkCount = 0;
+        };
+
+        std::vector<float> CreateSine(size_t length)
+        {
+            std::vector<float> data(length);
+            for (size_t i = 0; i < length; i++)
+                data[i] = static_cast<float>(0.5 * std::sin(i * 0.01));
+            return data;
+        }
+
+        // The implementation used by UnityAudioTrackSource before: convert sample by sample, and erase every
+        // delivered chunk from the front of a vector.
+        class VectorEraseChunker
+        {
+        public:
+            void Push(const float* data, int sampleRate, size_t channels, size_t length, AudioTrackSinkInterface* sink)
+            {
+                size_t framesFor10ms = static_cast<size_t>(sampleRate / 100);
+                size_t samplesFor10ms = framesFor10ms * channels;
+                for (size_t i = 0; i < length; i++)
+                    buffer_.push_back(::webrtc::FloatToS16(data[i]));
+                while (buffer_.size() >= samplesFor10ms)
+                {
+                    sink->OnData(buffer_.data(), 16, sampleRate, channels, framesFor10ms);
+                    buffer_.erase(buffer_.begin(), buffer_.begin() + samplesFor10ms);
+                }
+            }
+
+        private:
+            std::vector<int16_t> buffer_;
+        };
+    }
+
+    TEST(AudioTrackSourceTest, DeliverAllSamplesIn10msChunks)
+    {
+        const int kSampleRate = 48000;
+        const size_t kChannels = 2;
+        const size_t kFrames = 1024;
+        const size_t kLength = kFrames * kChannels;
+        const int kBlocks = 50;
+
+        auto source = UnityAudioTrackSource::Create();
+        FakeAudioSink sink;
+        source->AddSink(&sink);
+
+        std::vector<float> data = CreateSine(kLength * kBlocks);
+        for (int i = 0; i < kBlocks; i++)
+            source->PushAudioData(data.data() + i * kLength, kSampleRate, kChannels, kFrames);
+        source->RemoveSink(&sink);
+
+        // Only the samples of the last incomplete chunk are kept back.
+        const size_t samplesFor10ms = kSampleRate / 100 * kChannels;
+        const size_t expectedChunks = kLength * kBlocks / samplesFor10ms;
+        EXPECT_EQ(static_cast<int>(expectedChunks), sink.chunkCount);
+        ASSERT_EQ(expectedChunks * samplesFor10ms, sink.samples.size());
+        for (size_t i = 0; i < sink.samples.size(); i++)
+            ASSERT_EQ(::webrtc::FloatToS16(data[i]), sink.samples[i]) << "at " << i;
+    }
+
+    TEST(AudioTrackSourceTest, KeepSamplesWhenPushedDataGetsLarger)
+    {
+        const int kSampleRate = 48000;
+        const size_t kChannels = 2;
+
+        auto source = UnityAudioTrackSource::Create();
+        FakeAudioSink sink;
+        source->AddSink(&sink);
+
+        std::vector<float> data = CreateSine(256 + 4096);
+        source->PushAudioData(data.data(), kSampleRate, kChannels, 256 / kChannels);
+        EXPECT_EQ(0, sink.chunkCount);
+        source->PushAudioData(data.data() + 256, kSampleRate, kChannels, 4096 / kChannels);
+        source->RemoveSink(&sink);
+
+        ASSERT_EQ(4u * 960u, sink.samples.size());
+        for (size_t i = 0; i < sink.samples.size(); i++)
+            ASSERT_EQ(::webrtc::FloatToS16(data[i]), sink.samples[i]) << "at " << i;
+    }
+
+    // Pushes one second of a sine sweep on each channel, with a different start frequency per channel.
+    class AudioTrackSourceChannelsTest : public testing::TestWithParam<size_t>
+    {
+    protected:
+        static constexpr double kPi = 3.14159265358979323846;
+
+        static std::vector<float> CreateSweep(int sampleRate, size_t channels, size_t frames)
+        {
+            std::vector<float> data(frames * channels);
+            for (size_t ch = 0; ch < channels; ch++)
+            {
+                double phase = 0;
+                for (size_t i = 0; i < frames; i++)
+                {
+                    const double frequency = 200.0 * (ch + 1) + 4000.0 * i / frames;
+                    phase += 2 * kPi * frequency / sampleRate;
+                    data[i * channels + ch] = static_cast<float>(0.5 * std::sin(phase));
+                }
+            }
+            return data;
+        }
+    };
+
+    TEST_P(AudioTrackSourceChannelsTest, RoundTripInterleavedSweep)
+    {
+        const int kSampleRate = 48000;
+        const size_t kFramesPerBlock = 1024;
+        const size_t channels = GetParam();
+        const size_t frames = kSampleRate;
+
+        auto source = UnityAudioTrackSource::Create();
+        FakeAudioSink sink;
+        source->AddSink(&sink);
+
+        std::vector<float> data = CreateSweep(kSampleRate, channels, frames);
+        for (size_t pushed = 0; pushed < frames; pushed += kFramesPerBlock)
+        {
+            const size_t blockFrames = std::min(kFramesPerBlock, frames - pushed);
+            source->PushAudioData(data.data() + pushed * channels, kSampleRate, channels, blockFrames);
+        }
+        source->RemoveSink(&sink);
+
+        // One second of audio is delivered as 100 chunks of 10 ms, with every channel.
+        EXPECT_EQ(100, sink.chunkCount);
+        EXPECT_EQ(channels, sink.channels);
+        ASSERT_EQ(data.size(), sink.samples.size());
+        for (size_t i = 0; i < data.size(); i++)
+            ASSERT_EQ(::webrtc::FloatToS16(data[i]), sink.samples[i]) << "frame " << i / channels << " channel "
+                                                                       << i % channels;
+    }
+
+    INSTANTIATE_TEST_SUITE_P(StereoAnd5_1, AudioTrackSourceChannelsTest, testing::Values(size_t { 2 }, size_t { 6 }));
+
+    TEST(AudioTrackSourceTest, IgnoreTooManyChannels)
+    {
+        const size_t kChannels = UnityAudioTrackSource::kMaxNumChannels + 1;
+        auto source = UnityAudioTrackSource::Create();
+        FakeAudioSink sink;
+        source->AddSink(&sink);
+
+        std::vector<float> data(480 * kChannels);
+        source->PushAudioData(data.data(), 48000, kChannels, 480);
+        source->RemoveSink(&sink);
+        EXPECT_EQ(0, sink.chunkCount);
+    }
+
+    class AudioTrackSourceBenchmark : public testing::Test
+    {
+    protected:
+        static constexpr int kSampleRate = 48000;
+        static constexpr size_t kChannels = 2;
+        static constexpr size_t kFramesPerBlock = 1024;
+        static constexpr int kSeconds = 60;
+    };
+
+    // Pushes 48 kHz stereo audio in the 1024 frame blocks of OnAudioFilterRead.
+    TEST_F(AudioTrackSourceBenchmark, DISABLED_Push48kHzStereo)
+    {
+        const size_t length = kFramesPerBlock * kChannels;
+        const int blocks = static_cast<int>(kSampleRate * kSeconds / kFramesPerBlock);
+        std::vector<float> data = CreateSine(length);
+
+        CountingAudioSink vectorSink;
+        VectorEraseChunker chunker;
+        int64_t start = rtc::TimeNanos();
+        for (int i = 0; i < blocks; i++)
+            chunker.Push(data.data(), kSampleRate, kChannels, length, &vectorSink);
+        const int64_t vectorEraseNs = rtc::TimeNanos() - start;
+
+        auto source = UnityAudioTrackSource::Create();
+        CountingAudioSink sink;
+        source->AddSink(&sink);
+        start = rtc::TimeNanos();
+        for (int i = 0; i < blocks; i++)
+            source->PushAudioData(data.data(), kSampleRate, kChannels, kFramesPerBlock);
+        const int64_t sourceNs = rtc::TimeNanos() - start;
+        source->RemoveSink(&sink);
+        EXPECT_EQ(vectorSink.chunkCount, sink.chunkCount);
+
+        const int vectorEraseUs = static_cast<int>(vectorEraseNs / kSeconds / 1000);
+        const int sourceUs = static_cast<int>(sourceNs / kSeconds / 1000);
+        ReportBenchmark(
+            "48kHz stereo",
+            { { "vector_erase_us_per_audio_second", vectorEraseUs },
+              { "ring_buffer_us_per_audio_second", sourceUs } });
+    }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace unity
+{
+namespace webrtc
+{
+    // Benchmarks compare the former implementation of a path with the current one and never assert on timing. Their
+    // names start with DISABLED_ so that they stay out of the unit test run. Run them with
+    //   WebRTCLibTest --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+    using BenchmarkResult = std::pair<std::string, int>;
+
+    // Records each result as a property of the running test and prints them on one line.
+    inline void ReportBenchmark(const std::string& name, std::initializer_list<BenchmarkResult> results)
+    {
+        std::cout << "[ BENCH    ] " << name << ":";
+        for (const BenchmarkResult& result : results)
+        {
+            testing::Test::RecordProperty(result.first, result.second);
+            std::cout << " " << result.first << "=" << result.second;
+        }
+        std::cout << std::endl;
+    }
+
+} // end namespace webrtc
+} // end namespace unity
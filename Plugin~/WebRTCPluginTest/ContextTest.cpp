@@ -1,7 +1,13 @@
 #include "pch.h"
 
+#include <map>
+#include <string>
+
+#include <api/stats/rtcstats_objects.h>
 #include <rtc_base/ref_counted_object.h>
+#include <rtc_base/time_utils.h>
 
+#include "Benchmark.h"
 #include "Context.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "GraphicsDevice/ITexture2D.h"
@@ -190,5 +196,124 @@ namespace webrtc
 
     INSTANTIATE_TEST_SUITE_P(GfxDevice, ContextTest, testing::ValuesIn(supportedGfxDevices));
 
+    TEST(StatsTypeTest, GetStatsTypeId)
+    {
+        EXPECT_EQ(2u, GetStatsTypeId(RTCOutboundRtpStreamStats::kType));
+        // A name which is not the constant of the stats class is compared by its characters.
+        const std::string candidatePair = "candidate-pair";
+        EXPECT_EQ(10u, GetStatsTypeId(candidatePair.c_str()));
+        EXPECT_EQ(kStatsTypeUnknown, GetStatsTypeId("new-stats-type"));
+
+        EXPECT_STREQ("outbound-rtp", GetStatsTypeName(2));
+        EXPECT_EQ(nullptr, GetStatsTypeName(kStatsTypeUnknown));
+    }
+
+    class StatsTypeBenchmark : public testing::Test
+    {
+    protected:
+        static constexpr int kStatsCount = 500;
+        static constexpr int kIterations = 1000;
+
+        // The table used by GetStatsList before.
+        const std::map<std::string, uint32_t> statsTypes_ = {
+            { "codec", 0 },
+            { "inbound-rtp", 1 },
+            { "outbound-rtp", 2 },
+            { "remote-inbound-rtp", 3 },
+            { "remote-outbound-rtp", 4 },
+            { "media-source", 5 },
+            { "media-playout", 6 },
+            { "peer-connection", 7 },
+            { "data-channel", 8 },
+            { "transport", 9 },
+            { "candidate-pair", 10 },
+            { "local-candidate", 11 },
+            { "remote-candidate", 12 },
+            { "certificate", 13 },
+            { "stream", 21 },
+            { "track", 22 }
+        };
+
+        static rtc::scoped_refptr<RTCStatsReport> CreateReport()
+        {
+            const Timestamp timestamp = Timestamp::Micros(0);
+            auto report = RTCStatsReport::Create(timestamp);
+            for (int i = 0; i < kStatsCount; i++)
+            {
+                const std::string id = std::to_string(i);
+                switch (i % 5)
+                {
+                case 0:
+                    report->AddStats(std::make_unique<RTCOutboundRtpStreamStats>("OT" + id, timestamp));
+                    break;
+                case 1:
+                    report->AddStats(std::make_unique<RTCInboundRtpStreamStats>("IT" + id, timestamp));
+                    break;
+                case 2:
+                    report->AddStats(std::make_unique<RTCCodecStats>("C" + id, timestamp));
+                    break;
+                case 3:
+                    report->AddStats(std::make_unique<RTCIceCandidatePairStats>("CP" + id, timestamp));
+                    break;
+                default:
+                    report->AddStats(std::make_unique<RTCTransportStats>("T" + id, timestamp));
+                    break;
+                }
+            }
+            return report;
+        }
+    };
+
+    // Lists the stats of a report of 500 stats, as reading a report through the C API starts with.
+    TEST_F(StatsTypeBenchmark, DISABLED_GetStatsList500Stats)
+    {
+        ContextDependencies dependencies = {};
+        Context context(dependencies);
+        rtc::scoped_refptr<const RTCStatsReport> report = CreateReport();
+        context.AddStatsReport(report);
+
+        uint64_t mapSum = 0;
+        int64_t start = rtc::TimeNanos();
+        for (int n = 0; n < kIterations; n++)
+        {
+            size_t length = report->size();
+            uint32_t* types = static_cast<uint32_t*>(CoTaskMemAlloc(sizeof(uint32_t) * length));
+            const RTCStats** list = static_cast<const RTCStats**>(CoTaskMemAlloc(sizeof(RTCStats*) * length));
+            int i = 0;
+            for (const auto& stats : *report)
+            {
+                list[i] = &stats;
+                types[i] = statsTypes_.at(stats.type());
+                i++;
+            }
+            for (size_t j = 0; j < length; j++)
+                mapSum += types[j];
+            CoTaskMemFree(types);
+            CoTaskMemFree(list);
+        }
+        const int64_t mapNs = rtc::TimeNanos() - start;
+
+        uint64_t tableSum = 0;
+        start = rtc::TimeNanos();
+        for (int n = 0; n < kIterations; n++)
+        {
+            size_t length = 0;
+            uint32_t* types = nullptr;
+            const RTCStats** list = context.GetStatsList(report.get(), &length, &types);
+            for (size_t j = 0; j < length; j++)
+                tableSum += types[j];
+            CoTaskMemFree(types);
+            CoTaskMemFree(list);
+        }
+        const int64_t tableNs = rtc::TimeNanos() - start;
+        context.DeleteStatsReport(report.get());
+        EXPECT_EQ(mapSum, tableSum);
+
+        ReportBenchmark(
+            std::to_string(kStatsCount) + " stats",
+            { { "map_ns_per_stats", static_cast<int>(mapNs / kIterations / kStatsCount) },
+              { "table_ns_per_stats", static_cast<int>(tableNs / kIterations / kStatsCount) } });
+    }
+
 } // end namespace webrtc
 } // end namespace unity
@@ -0,0 +1,146 @@
+#include "pch.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <api/video/i420_buffer.h>
+#include <rtc_base/time_utils.h>
+#include <third_party/libyuv/include/libyuv/video_common.h>
+
+#include "Benchmark.h"
+#include "GraphicsDevice/ConversionThreadPool.h"
+#include "GraphicsDevice/GraphicsUtility.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace
+    {
+        bool EqualPlane(const uint8_t* a, int strideA, const uint8_t* b, int strideB, int width, int height)
+        {
+            for (int y = 0; y < height; y++)
+            {
+                if (std::memcmp(a + y * strideA, b + y * strideB, width) != 0)
+                    return false;
+            }
+            return true;
+        }
+
+        bool EqualI420(const webrtc::I420Buffer& a, const webrtc::I420Buffer& b)
+        {
+            return EqualPlane(a.DataY(), a.StrideY(), b.DataY(), b.StrideY(), a.width(), a.height()) &&
+                EqualPlane(a.DataU(), a.StrideU(), b.DataU(), b.StrideU(), a.ChromaWidth(), a.ChromaHeight()) &&
+                EqualPlane(a.DataV(), a.StrideV(), b.DataV(), b.StrideV(), a.ChromaWidth(), a.ChromaHeight());
+        }
+
+        std::vector<uint8_t> CreateRGBImage(int width, int height)
+        {
+            std::vector<uint8_t> image(static_cast<size_t>(width) * height * 4);
+            for (size_t i = 0; i < image.size(); i++)
+                image[i] = static_cast<uint8_t>(i * 7 + i / 4093);
+            return image;
+        }
+    }
+
+    TEST(ConversionThreadPoolTest, RunEveryIndexOnce)
+    {
+        ConversionThreadPool pool(4);
+        EXPECT_EQ(4u, pool.threadCount());
+
+        std::vector<std::atomic<int>> calls(100);
+        pool.ParallelFor(calls.size(), [&calls](size_t index) { calls[index]++; });
+        for (auto& count : calls)
+            EXPECT_EQ(1, count.load());
+    }
+
+    TEST(ConversionThreadPoolTest, ChangeThreadCount)
+    {
+        ConversionThreadPool pool(1);
+        EXPECT_EQ(1u, pool.threadCount());
+        pool.SetThreadCount(0);
+        EXPECT_EQ(1u, pool.threadCount());
+        pool.SetThreadCount(3);
+        EXPECT_EQ(3u, pool.threadCount());
+        pool.SetThreadCount(ConversionThreadPool::kMaxThreadCount + 1);
+        EXPECT_EQ(ConversionThreadPool::kMaxThreadCount, pool.threadCount());
+
+        std::atomic<size_t> sum(0);
+        pool.ParallelFor(10, [&sum](size_t index) { sum += index; });
+        EXPECT_EQ(45u, sum.load());
+    }
+
+    class StripedConversionTest : public testing::TestWithParam<std::tuple<int, int>>
+    {
+    };
+
+    TEST_P(StripedConversionTest, SameAsSingleThread)
+    {
+        const int width = std::get<0>(GetParam());
+        const int height = std::get<1>(GetParam());
+        const std::vector<uint8_t> image = CreateRGBImage(width, height);
+        ConversionThreadPool pool(4);
+
+        for (uint32_t fourcc : { libyuv::FOURCC_ARGB, libyuv::FOURCC_ABGR })
+        {
+            auto expected = webrtc::I420Buffer::Create(width, height);
+            GraphicsUtility::ConvertRGBToI420(image.data(), width * 4, width, height, fourcc, expected.get());
+            auto striped = webrtc::I420Buffer::Create(width, height);
+            GraphicsUtility::ConvertRGBToI420(image.data(), width * 4, width, height, fourcc, striped.get(), &pool);
+            EXPECT_TRUE(EqualI420(*expected, *striped));
+        }
+    }
+
+    // Odd heights check that the last band converts the trailing chroma row.
+    INSTANTIATE_TEST_SUITE_P(
+        Sizes,
+        StripedConversionTest,
+        testing::Values(
+            std::make_tuple(64, 63),
+            std::make_tuple(320, 241),
+            std::make_tuple(642, 363),
+            std::make_tuple(1280, 720),
+            std::make_tuple(1920, 1081)));
+
+    class StripedConversionBenchmark : public testing::Test
+    {
+    protected:
+        int64_t Run(int width, int height, ConversionThreadPool* pool)
+        {
+            const std::vector<uint8_t> image = CreateRGBImage(width, height);
+            auto buffer = webrtc::I420Buffer::Create(width, height);
+            const int64_t start = rtc::TimeNanos();
+            for (int i = 0; i < kFrames; i++)
+            {
+                GraphicsUtility::ConvertRGBToI420(
+                    image.data(), width * 4, width, height, libyuv::FOURCC_ARGB, buffer.get(), pool);
+            }
+            return rtc::TimeNanos() - start;
+        }
+
+        void Measure(const char* name, int width, int height)
+        {
+            const int64_t singleNs = Run(width, height, nullptr);
+            ConversionThreadPool pool(kThreadCount);
+            const int64_t stripedNs = Run(width, height, &pool);
+
+            const std::string prefix(name);
+            ReportBenchmark(
+                prefix + " " + std::to_string(width) + "x" + std::to_string(height),
+                { { prefix + "_single_thread_us_per_frame", static_cast<int>(singleNs / kFrames / 1000) },
+                  { prefix + "_striped_us_per_frame", static_cast<int>(stripedNs / kFrames / 1000) } });
+        }
+
+        static constexpr int kFrames = 30;
+        static constexpr size_t kThreadCount = 4;
+    };
+
+    TEST_F(StripedConversionBenchmark, DISABLED_FullHD) { Measure("1080p", 1920, 1080); }
+
+    TEST_F(StripedConversionBenchmark, DISABLED_UHD) { Measure("2160p", 3840, 2160); }
+
+} // end namespace webrtc
+} // end namespace unity
@@ -0,0 +1,186 @@
+#include "pch.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <rtc_base/time_utils.h>
+
+#include "Context.h"
+#include "DataChannelObject.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    class DataChannelObjectTest : public testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            ContextDependencies dependencies = {};
+            context_ = std::make_unique<Context>(dependencies);
+            const PeerConnectionInterface::RTCConfiguration config;
+            connection_ = context_->CreatePeerConnection(config);
+            ASSERT_NE(nullptr, connection_);
+            DataChannelInit init;
+            channel_ = context_->CreateDataChannel(connection_, "test", init);
+            ASSERT_NE(nullptr, channel_);
+            object_ = context_->GetDataChannelObject(channel_);
+            s_received.clear();
+            s_bufferedAmountLowCount = 0;
+        }
+
+        void TearDown() override
+        {
+            if (channel_)
+                context_->DeleteDataChannel(channel_);
+            if (connection_)
+                context_->DeletePeerConnection(connection_);
+        }
+
+        static void OnMessage(DataChannelInterface*, const uint8_t* data, int32_t size)
+        {
+            s_received.emplace_back(data, data + size);
+        }
+
+        static void OnBufferedAmountLow(DataChannelInterface*, uint64_t) { s_bufferedAmountLowCount++; }
+
+        static webrtc::DataBuffer CreateMessage(uint32_t index)
+        {
+            rtc::CopyOnWriteBuffer buffer(reinterpret_cast<const uint8_t*>(&index), sizeof(index));
+            return webrtc::DataBuffer(buffer, true);
+        }
+
+        static std::vector<std::vector<uint8_t>> s_received;
+        static int s_bufferedAmountLowCount;
+        std::unique_ptr<Context> context_;
+        PeerConnectionObject* connection_ = nullptr;
+        DataChannelInterface* channel_ = nullptr;
+        DataChannelObject* object_ = nullptr;
+    };
+
+    std::vector<std::vector<uint8_t>> DataChannelObjectTest::s_received;
+    int DataChannelObjectTest::s_bufferedAmountLowCount;
+
+    TEST_F(DataChannelObjectTest, ReturnNullForDeletedChannel)
+    {
+        ASSERT_NE(nullptr, object_);
+        context_->DeleteDataChannel(channel_);
+        EXPECT_EQ(nullptr, context_->GetDataChannelObject(channel_));
+        // The lookup does not add the channel again.
+        EXPECT_EQ(nullptr, context_->GetDataChannelObject(channel_));
+        channel_ = nullptr;
+    }
+
+    TEST_F(DataChannelObjectTest, PassMessagesToCallbackByDefault)
+    {
+        object_->RegisterOnMessage(&OnMessage);
+        object_->OnMessage(webrtc::DataBuffer("hello"));
+        ASSERT_EQ(1u, s_received.size());
+        EXPECT_EQ(std::vector<uint8_t>({ 'h', 'e', 'l', 'l', 'o' }), s_received[0]);
+
+        DataChannelMessageView views[4];
+        EXPECT_EQ(0u, object_->ReceiveMessages(views, 4));
+    }
+
+    TEST_F(DataChannelObjectTest, QueueMessagesWithoutCopying)
+    {
+        object_->RegisterOnMessage(&OnMessage);
+        object_->SetQueuedDelivery(true);
+
+        rtc::CopyOnWriteBuffer text("abc", 3);
+        object_->OnMessage(webrtc::DataBuffer(text, false));
+        for (uint32_t i = 0; i < 4; i++)
+            object_->OnMessage(CreateMessage(i));
+        EXPECT_TRUE(s_received.empty());
+
+        DataChannelMessageView views[3];
+        ASSERT_EQ(3u, object_->ReceiveMessages(views, 3));
+        // The view points to the buffer which was received.
+        EXPECT_EQ(text.cdata(), views[0].data);
+        EXPECT_EQ(3, views[0].size);
+        EXPECT_EQ(0, views[0].binary);
+        for (uint32_t i = 1; i < 3; i++)
+        {
+            uint32_t index;
+            ASSERT_EQ(static_cast<int32_t>(sizeof(index)), views[i].size);
+            std::memcpy(&index, views[i].data, sizeof(index));
+            EXPECT_EQ(i - 1, index);
+            EXPECT_EQ(1, views[i].binary);
+        }
+        object_->ReleaseMessages();
+
+        ASSERT_EQ(2u, object_->ReceiveMessages(views, 3));
+        object_->ReleaseMessages();
+        EXPECT_EQ(0u, object_->ReceiveMessages(views, 3));
+    }
+
+    // OnMessage and ReceiveMessages run on their own threads at the same time, like the network and the managed
+    // threads.
+    TEST_F(DataChannelObjectTest, NoMessageLostOrReorderedBetweenThreads)
+    {
+        const uint32_t kMessages = 100000;
+        object_->SetQueuedDelivery(true);
+
+        std::thread producer(
+            [this]()
+            {
+                for (uint32_t i = 0; i < kMessages; i++)
+                    object_->OnMessage(CreateMessage(i));
+            });
+
+        uint32_t received = 0;
+        size_t mismatches = 0;
+        const int64_t deadline = rtc::TimeMillis() + 30000;
+        std::vector<DataChannelMessageView> views(64);
+        while (received < kMessages && rtc::TimeMillis() < deadline)
+        {
+            const size_t count = object_->ReceiveMessages(views.data(), views.size());
+            for (size_t i = 0; i < count; i++)
+            {
+                uint32_t index;
+                std::memcpy(&index, views[i].data, sizeof(index));
+                if (index != received)
+                    mismatches++;
+                received++;
+            }
+            object_->ReleaseMessages();
+            if (count == 0)
+                std::this_thread::yield();
+        }
+        producer.join();
+
+        EXPECT_EQ(kMessages, received);
+        EXPECT_EQ(0u, mismatches);
+    }
+
+    TEST_F(DataChannelObjectTest, SendBatchStopsAtRefusedMessage)
+    {
+        const uint8_t data[] = { 1, 2, 3 };
+        const DataChannelSpan messages[] = { { data, 1 }, { data + 1, 2 } };
+        // The channel is not open, so it refuses the first message.
+        EXPECT_EQ(0u, object_->SendBatch(messages, 2));
+        EXPECT_EQ(0u, object_->SendBatch(messages, 0));
+    }
+
+    TEST_F(DataChannelObjectTest, NotifyWhenBufferedAmountFallsToThreshold)
+    {
+        object_->RegisterOnBufferedAmountLow(&OnBufferedAmountLow);
+        object_->SetBufferedAmountLowThreshold(100);
+        EXPECT_EQ(100u, object_->GetBufferedAmountLowThreshold());
+
+        // The buffered amount of the channel is 0, so it was 50 before and never above the threshold.
+        object_->OnBufferedAmountChange(50);
+        EXPECT_EQ(0, s_bufferedAmountLowCount);
+        object_->OnBufferedAmountChange(150);
+        EXPECT_EQ(1, s_bufferedAmountLowCount);
+
+        object_->SetBufferedAmountLowThreshold(0);
+        object_->OnBufferedAmountChange(1);
+        EXPECT_EQ(2, s_bufferedAmountLowCount);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
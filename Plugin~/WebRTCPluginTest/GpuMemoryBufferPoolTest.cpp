@@ -1,7 +1,14 @@
 #include "pch.h"
 
+#include <algorithm>
+
+#include <api/make_ref_counted.h>
+#include <rtc_base/time_utils.h>
+
+#include "Benchmark.h"
 #include "GpuMemoryBufferPool.h"
 #include "GraphicsDevice/ITexture2D.h"
+#include "GraphicsDevice/Software/SoftwareGraphicsDevice.h"
 #include "GraphicsDeviceContainer.h"
 
 namespace unity
@@ -142,7 +149,246 @@ namespace webrtc
         EXPECT_EQ(0u, bufferPool_->bufferCount());
     }
 
+    TEST_P(GpuMemoryBufferPoolTest, LimitInFlightFramesPerSource)
+    {
+        const Size kSize(kWidth, kHeight);
+        auto tex = CreateTexture(kSize, kFormat);
+        void* ptr = tex->GetNativeTexturePtrV();
+        int source1 = 0;
+        int source2 = 0;
+
+        bufferPool_->SetBudget({ 0, 2 });
+        auto frame1 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source1);
+        auto frame2 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source1);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame1, nullptr);
+        EXPECT_NE(frame2, nullptr);
+        EXPECT_EQ(2u, bufferPool_->inFlightFrames(&source1));
+
+        // The first source reached the limit, but the other one is not affected.
+        auto frame3 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source1);
+        EXPECT_EQ(frame3, nullptr);
+        auto frame4 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source2);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame4, nullptr);
+
+        frame1 = nullptr;
+        EXPECT_EQ(1u, bufferPool_->inFlightFrames(&source1));
+        auto frame5 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source1);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame5, nullptr);
+    }
+
+    TEST_P(GpuMemoryBufferPoolTest, EvictOtherResolutionsOverByteBudget)
+    {
+        const Size kSize1(kWidth, kHeight);
+        const Size kSize2(kWidth / 2, kHeight / 2);
+        auto tex1 = CreateTexture(kSize1, kFormat);
+        auto tex2 = CreateTexture(kSize2, kFormat);
+
+        const size_t bytes1 = bufferPool_->EstimateBufferBytes(kSize1);
+        const size_t bytes2 = bufferPool_->EstimateBufferBytes(kSize2);
+        bufferPool_->SetBudget({ bytes1 * 2, 0 });
+
+        auto frame1 = bufferPool_->CreateFrame(tex2->GetNativeTexturePtrV(), kSize2, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        frame1 = nullptr;
+        auto frame2 = bufferPool_->CreateFrame(tex1->GetNativeTexturePtrV(), kSize1, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(2u, bufferPool_->bufferCount());
+        EXPECT_EQ(bytes1 + bytes2, bufferPool_->totalBytes());
+
+        // The unused buffer of the other resolution is released to make room.
+        auto frame3 = bufferPool_->CreateFrame(tex1->GetNativeTexturePtrV(), kSize1, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame3, nullptr);
+        EXPECT_EQ(2u, bufferPool_->bufferCount());
+        EXPECT_EQ(bytes1 * 2, bufferPool_->totalBytes());
+    }
+
+    TEST_P(GpuMemoryBufferPoolTest, DropFrameOverByteBudget)
+    {
+        const Size kSize(kWidth, kHeight);
+        auto tex = CreateTexture(kSize, kFormat);
+        void* ptr = tex->GetNativeTexturePtrV();
+
+        bufferPool_->SetBudget({ bufferPool_->EstimateBufferBytes(kSize), 0 });
+        auto frame1 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(frame1, nullptr);
+
+        // All buffers are in use, so nothing can be released.
+        auto frame2 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime());
+        EXPECT_EQ(frame2, nullptr);
+        EXPECT_EQ(1u, bufferPool_->bufferCount());
+    }
+
+    TEST_P(GpuMemoryBufferPoolTest, CpuReadbackOnDemand)
+    {
+        const Size kSize(kWidth, kHeight);
+        auto tex = CreateTexture(kSize, kFormat);
+        void* ptr = tex->GetNativeTexturePtrV();
+        const size_t textureBytes = GpuMemoryBufferPool::EstimateTextureBytes(kSize);
+        int source1 = 0;
+        int source2 = 0;
+
+        bufferPool_->SetCpuReadback(GpuMemoryBufferPool::CpuReadback::OnDemand);
+        EXPECT_EQ(textureBytes, bufferPool_->EstimateBufferBytes(kSize, &source1));
+        auto frame1 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source1);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_EQ(textureBytes, bufferPool_->totalBytes());
+        EXPECT_EQ(0u, bufferPool_->cpuReadBytes());
+
+        // The copy is not made off the rendering thread, so the first read drops the frame and requests the copy.
+        EXPECT_EQ(nullptr, frame1->GetGpuMemoryBuffer()->ToI420());
+        frame1 = nullptr;
+        EXPECT_EQ(0u, bufferPool_->cpuReadBytes());
+
+        // Only the frames of the source which has been read fill the copy when capturing.
+        EXPECT_EQ(textureBytes * 2, bufferPool_->EstimateBufferBytes(kSize, &source1));
+        EXPECT_EQ(textureBytes, bufferPool_->EstimateBufferBytes(kSize, &source2));
+        auto frame2 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source1);
+        auto frame3 = bufferPool_->CreateFrame(ptr, kSize, kFormat, clock_.CurrentTime(), &source2);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+        EXPECT_NE(nullptr, frame2->GetGpuMemoryBuffer()->ToI420());
+        EXPECT_EQ(2u, bufferPool_->bufferCount());
+        EXPECT_EQ(textureBytes * 3, bufferPool_->totalBytes());
+        frame2 = nullptr;
+        frame3 = nullptr;
+
+        // The request expires when the frames are no longer read.
+        clock_.AdvanceTime(CpuReadRequest::kTimeout);
+        EXPECT_EQ(textureBytes, bufferPool_->EstimateBufferBytes(kSize, &source1));
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDevice, GpuMemoryBufferPoolTest, testing::ValuesIn(supportedGfxDevices));
 
+    // Reproduces the former pool which scanned one list on every capture and every return.
+    // Only used as the baseline of the benchmark below.
+    class LinearScanBufferPool
+    {
+    public:
+        explicit LinearScanBufferPool(IGraphicsDevice* device)
+            : device_(device)
+        {
+        }
+
+        rtc::scoped_refptr<VideoFrame>
+        CreateFrame(NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format, Timestamp timestamp)
+        {
+            rtc::scoped_refptr<GpuMemoryBufferInterface> buffer = GetOrCreate(ptr, size, format);
+            VideoFrame::ReturnBufferToPoolCallback callback =
+                std::bind(&LinearScanBufferPool::OnReturnBuffer, this, std::placeholders::_1);
+            return VideoFrame::WrapExternalGpuMemoryBuffer(
+                size, buffer, callback, TimeDelta::Micros(timestamp.us()));
+        }
+
+        size_t bufferCount() { return pool_.size(); }
+
+    private:
+        struct Entry
+        {
+            rtc::scoped_refptr<GpuMemoryBufferFromUnity> buffer;
+            bool used;
+        };
+
+        rtc::scoped_refptr<GpuMemoryBufferInterface>
+        GetOrCreate(NativeTexPtr ptr, const Size& size, UnityRenderingExtTextureFormat format)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& entry : pool_)
+            {
+                if (!entry.used && entry.buffer->GetSize() == size && entry.buffer->GetFormat() == format &&
+                    entry.buffer->ResetSync() && entry.buffer->CopyBuffer(ptr))
+                {
+                    entry.used = true;
+                    return entry.buffer;
+                }
+            }
+            auto buffer = rtc::make_ref_counted<GpuMemoryBufferFromUnity>(device_, size, format);
+            buffer->CopyBuffer(ptr);
+            pool_.push_back({ buffer, true });
+            return buffer;
+        }
+
+        void OnReturnBuffer(rtc::scoped_refptr<GpuMemoryBufferInterface> buffer)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto result = std::find_if(
+                pool_.begin(), pool_.end(), [&buffer](const Entry& x) { return x.buffer.get() == buffer.get(); });
+            result->used = false;
+        }
+
+        IGraphicsDevice* device_;
+        std::mutex mutex_;
+        std::list<Entry> pool_;
+    };
+
+    class GpuMemoryBufferPoolBenchmark : public testing::Test
+    {
+    protected:
+        GpuMemoryBufferPoolBenchmark()
+            : device_(kUnityGfxRendererNull, nullptr)
+            , clock_(0)
+        {
+            for (int i = 0; i < kResolutionCount; i++)
+            {
+                // Keep textures small so that the pool bookkeeping dominates the copies.
+                const Size size(16 + 2 * i, 16);
+                sizes_.push_back(size);
+                textures_.emplace_back(device_.CreateDefaultTextureV(
+                    static_cast<uint32_t>(size.width()), static_cast<uint32_t>(size.height()), kFormat));
+            }
+        }
+
+        // Simulates a capture loop where every track keeps a few frames in the encoder queue.
+        template<typename Pool>
+        int64_t Run(Pool& pool)
+        {
+            std::vector<std::deque<rtc::scoped_refptr<VideoFrame>>> inflight(kResolutionCount);
+            const int64_t start = rtc::TimeNanos();
+            for (int round = 0; round < kRounds; round++)
+            {
+                for (int i = 0; i < kResolutionCount; i++)
+                {
+                    void* ptr = textures_[i]->GetNativeTexturePtrV();
+                    inflight[i].push_back(pool.CreateFrame(ptr, sizes_[i], kFormat, clock_.CurrentTime()));
+                    if (inflight[i].size() > kFramesInFlight)
+                        inflight[i].pop_front();
+                }
+            }
+            inflight.clear();
+            return rtc::TimeNanos() - start;
+        }
+
+        static constexpr int kResolutionCount = 24;
+        static constexpr size_t kFramesInFlight = 3;
+        static constexpr int kRounds = 500;
+        const UnityRenderingExtTextureFormat kFormat = kUnityRenderingExtFormatB8G8R8A8_UNorm;
+
+        SoftwareGraphicsDevice device_;
+        SimulatedClock clock_;
+        std::vector<Size> sizes_;
+        std::vector<std::unique_ptr<ITexture2D>> textures_;
+    };
+
+    TEST_F(GpuMemoryBufferPoolBenchmark, DISABLED_ManyResolutions)
+    {
+        LinearScanBufferPool linearPool(&device_);
+        const int64_t linearNs = Run(linearPool);
+
+        GpuMemoryBufferPool pool(&device_, &clock_);
+        const int64_t pooledNs = Run(pool);
+
+        // Both pools keep the same number of buffers alive.
+        EXPECT_EQ(linearPool.bufferCount(), pool.bufferCount());
+
+        const int frames = kRounds * kResolutionCount;
+        ReportBenchmark(
+            std::to_string(kResolutionCount) + " resolutions",
+            { { "linear_scan_ns_per_frame", static_cast<int>(linearNs / frames) },
+              { "free_list_ns_per_frame", static_cast<int>(pooledNs / frames) } });
+    }
+
 } // end namespace webrtc
 } // end namespace unity
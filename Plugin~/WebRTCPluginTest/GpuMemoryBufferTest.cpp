@@ -92,6 +92,40 @@ namespace webrtc
         }
     }
 
+    TEST_P(GpuMemoryBufferTest, ScaleToMultipleSizes)
+    {
+        const Size kSize2(static_cast<int>(kWidth / 2), static_cast<int>(kHeight / 2));
+        const Size kSize4(static_cast<int>(kWidth / 4), static_cast<int>(kHeight / 4));
+        std::unique_ptr<const ITexture2D> texture(device_->CreateDefaultTextureV(kWidth, kHeight, kFormat));
+        auto testFrame = CreateTestFrame(device_, texture.get(), kFormat);
+        EXPECT_TRUE(device_->WaitIdleForTest());
+
+        auto frame = VideoFrameAdapter::CreateVideoFrame(testFrame);
+        auto buffer = frame.video_frame_buffer();
+        auto layer1 = buffer->Scale(kSize.width(), kSize.height());
+        auto layer2 = buffer->Scale(kSize2.width(), kSize2.height());
+        auto layer3 = buffer->Scale(kSize4.width(), kSize4.height());
+
+        // All layers are converted together when the first one is read.
+        auto i420Buffer3 = layer3->ToI420();
+        auto i420Buffer2 = layer2->ToI420();
+        auto i420Buffer1 = layer1->ToI420();
+        ASSERT_NE(i420Buffer1, nullptr);
+        ASSERT_NE(i420Buffer2, nullptr);
+        ASSERT_NE(i420Buffer3, nullptr);
+        EXPECT_EQ(i420Buffer1->width(), kSize.width());
+        EXPECT_EQ(i420Buffer1->height(), kSize.height());
+        EXPECT_EQ(i420Buffer2->width(), kSize2.width());
+        EXPECT_EQ(i420Buffer2->height(), kSize2.height());
+        EXPECT_EQ(i420Buffer3->width(), kSize4.width());
+        EXPECT_EQ(i420Buffer3->height(), kSize4.height());
+
+        // The converted buffer is cached.
+        EXPECT_EQ(layer2->ToI420(), i420Buffer2);
+        auto layer4 = buffer->Scale(kSize2.width(), kSize2.height());
+        EXPECT_EQ(layer4->ToI420(), i420Buffer2);
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDevice, GpuMemoryBufferTest, testing::ValuesIn(supportedGfxDevices));
 
 } // end namespace webrtc
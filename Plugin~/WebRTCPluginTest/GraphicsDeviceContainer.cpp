@@ -523,7 +523,8 @@ namespace webrtc
         renderer_ = renderer;
 
         // native graphics device is not initialized.
-        if (!nativeGfxDevice_)
+        // The software device for kUnityGfxRendererNull runs without it.
+        if (!nativeGfxDevice_ && renderer != kUnityGfxRendererNull)
             return;
 
         IGraphicsDevice* device = nullptr;
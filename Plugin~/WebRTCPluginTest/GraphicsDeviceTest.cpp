@@ -113,6 +113,47 @@ namespace webrtc
         EXPECT_EQ(height, frameBuffer->height());
     }
 
+    TEST_P(GraphicsDeviceTest, ConvertRGBToI420ReusesBuffer)
+    {
+        const uint32_t width = 256;
+        const uint32_t height = 256;
+        const std::unique_ptr<ITexture2D> src(device()->CreateDefaultTextureV(width, height, format()));
+        const std::unique_ptr<ITexture2D> dst(device()->CreateCPUReadTextureV(width, height, format()));
+        EXPECT_TRUE(device()->WaitIdleForTest());
+        EXPECT_TRUE(device()->CopyResourceFromNativeV(dst.get(), src->GetNativeTexturePtrV()));
+        EXPECT_TRUE(device()->WaitIdleForTest());
+
+        I420BufferPool* pool = device()->GetI420BufferPool();
+        const uint64_t hitCount = pool->hitCount();
+        auto frameBuffer = device()->ConvertRGBToI420(dst.get());
+        EXPECT_NE(nullptr, frameBuffer);
+        const I420Buffer* address = frameBuffer.get();
+        frameBuffer = nullptr;
+
+        frameBuffer = device()->ConvertRGBToI420(dst.get());
+        EXPECT_EQ(address, frameBuffer.get());
+        EXPECT_EQ(hitCount + 1, pool->hitCount());
+    }
+
+    TEST_P(GraphicsDeviceTest, ConvertRGBToScaledI420)
+    {
+        const uint32_t width = 256;
+        const uint32_t height = 256;
+        const std::vector<Size> sizes = { Size(256, 256), Size(128, 128), Size(64, 64) };
+        const std::unique_ptr<ITexture2D> src(device()->CreateDefaultTextureV(width, height, format()));
+        const std::unique_ptr<ITexture2D> dst(device()->CreateCPUReadTextureV(width, height, format()));
+        EXPECT_TRUE(device()->WaitIdleForTest());
+        EXPECT_TRUE(device()->CopyResourceFromNativeV(dst.get(), src->GetNativeTexturePtrV()));
+        EXPECT_TRUE(device()->WaitIdleForTest());
+        const auto frameBuffers = device()->ConvertRGBToScaledI420(dst.get(), sizes);
+        ASSERT_EQ(sizes.size(), frameBuffers.size());
+        for (size_t i = 0; i < sizes.size(); i++)
+        {
+            EXPECT_EQ(sizes[i].width(), frameBuffers[i]->width());
+            EXPECT_EQ(sizes[i].height(), frameBuffers[i]->height());
+        }
+    }
+
     TEST_P(GraphicsDeviceTest, Map)
     {
         const uint32_t width = 256;
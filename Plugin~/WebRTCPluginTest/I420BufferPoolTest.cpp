@@ -0,0 +1,78 @@
+#include "pch.h"
+
+#include "GraphicsDevice/I420BufferPool.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    class I420BufferPoolTest : public testing::Test
+    {
+    protected:
+        I420BufferPool pool_;
+        const int kWidth = 256;
+        const int kHeight = 256;
+    };
+
+    TEST_F(I420BufferPoolTest, ReuseReleasedBuffer)
+    {
+        auto buffer1 = pool_.CreateBuffer(kWidth, kHeight);
+        ASSERT_NE(buffer1, nullptr);
+        EXPECT_EQ(kWidth, buffer1->width());
+        EXPECT_EQ(kHeight, buffer1->height());
+        const webrtc::I420Buffer* address = buffer1.get();
+        EXPECT_EQ(0u, pool_.hitCount());
+        EXPECT_EQ(1u, pool_.missCount());
+
+        buffer1 = nullptr;
+        auto buffer2 = pool_.CreateBuffer(kWidth, kHeight);
+        EXPECT_EQ(address, buffer2.get());
+        EXPECT_EQ(1u, pool_.hitCount());
+        EXPECT_EQ(1u, pool_.missCount());
+    }
+
+    TEST_F(I420BufferPoolTest, DoNotReuseBufferInUse)
+    {
+        auto buffer1 = pool_.CreateBuffer(kWidth, kHeight);
+        auto buffer2 = pool_.CreateBuffer(kWidth, kHeight);
+        EXPECT_NE(buffer1.get(), buffer2.get());
+        EXPECT_EQ(0u, pool_.hitCount());
+        EXPECT_EQ(2u, pool_.missCount());
+    }
+
+    TEST_F(I420BufferPoolTest, KeepBuffersOfEachResolution)
+    {
+        auto buffer1 = pool_.CreateBuffer(kWidth, kHeight);
+        auto buffer2 = pool_.CreateBuffer(kWidth / 2, kHeight / 2);
+        const webrtc::I420Buffer* address1 = buffer1.get();
+        const webrtc::I420Buffer* address2 = buffer2.get();
+        buffer1 = nullptr;
+        buffer2 = nullptr;
+
+        // Switching the resolution does not drop the buffers of the other one.
+        EXPECT_EQ(address1, pool_.CreateBuffer(kWidth, kHeight).get());
+        EXPECT_EQ(address2, pool_.CreateBuffer(kWidth / 2, kHeight / 2).get());
+        EXPECT_EQ(2u, pool_.resolutionCount());
+        EXPECT_EQ(2u, pool_.hitCount());
+    }
+
+    TEST_F(I420BufferPoolTest, LimitResolutionCount)
+    {
+        for (size_t i = 0; i < I420BufferPool::kMaxResolutions * 2; i++)
+        {
+            const int size = static_cast<int>(16 * (i + 1));
+            EXPECT_NE(pool_.CreateBuffer(size, size), nullptr);
+        }
+        EXPECT_EQ(I420BufferPool::kMaxResolutions, pool_.resolutionCount());
+    }
+
+    TEST_F(I420BufferPoolTest, Release)
+    {
+        auto buffer = pool_.CreateBuffer(kWidth, kHeight);
+        pool_.Release();
+        EXPECT_EQ(0u, pool_.resolutionCount());
+        EXPECT_EQ(kWidth, buffer->width());
+    }
+
+} // end namespace webrtc
+} // end namespace unity
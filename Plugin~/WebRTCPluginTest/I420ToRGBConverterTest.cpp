@@ -0,0 +1,188 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <api/video/i420_buffer.h>
+#include <rtc_base/time_utils.h>
+#include <third_party/libyuv/include/libyuv.h>
+
+#include "Benchmark.h"
+#include "I420ToRGBConverter.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace
+    {
+        rtc::scoped_refptr<webrtc::I420Buffer> CreateGradient(int width, int height)
+        {
+            rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Create(width, height);
+            for (int y = 0; y < height; y++)
+            {
+                uint8_t* row = buffer->MutableDataY() + y * buffer->StrideY();
+                for (int x = 0; x < width; x++)
+                    row[x] = static_cast<uint8_t>(16 + (x + y) * 200 / (width + height));
+            }
+            const int chromaWidth = buffer->ChromaWidth();
+            const int chromaHeight = buffer->ChromaHeight();
+            for (int y = 0; y < chromaHeight; y++)
+            {
+                uint8_t* u = buffer->MutableDataU() + y * buffer->StrideU();
+                uint8_t* v = buffer->MutableDataV() + y * buffer->StrideV();
+                for (int x = 0; x < chromaWidth; x++)
+                {
+                    u[x] = static_cast<uint8_t>(64 + x * 128 / chromaWidth);
+                    v[x] = static_cast<uint8_t>(64 + y * 128 / chromaHeight);
+                }
+            }
+            return buffer;
+        }
+
+        // The implementation used by UnityVideoRenderer before: scale into a new I420 buffer, then convert.
+        void ScaleThenConvert(
+            const webrtc::I420BufferInterface& src, int width, int height, uint32_t fourcc, uint8_t* dst)
+        {
+            rtc::scoped_refptr<webrtc::I420Buffer> scaled = webrtc::I420Buffer::Create(width, height);
+            scaled->ScaleFrom(src);
+            libyuv::ConvertFromI420(
+                scaled->DataY(),
+                scaled->StrideY(),
+                scaled->DataU(),
+                scaled->StrideU(),
+                scaled->DataV(),
+                scaled->StrideV(),
+                dst,
+                0,
+                width,
+                height,
+                fourcc);
+        }
+
+        int MaxDifference(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b)
+        {
+            int difference = 0;
+            for (size_t i = 0; i < a.size(); i++)
+                difference = std::max(difference, std::abs(a[i] - b[i]));
+            return difference;
+        }
+    }
+
+    class I420ToRGBConverterTest : public testing::TestWithParam<std::tuple<int, int, int, int>>
+    {
+    };
+
+    TEST_P(I420ToRGBConverterTest, CloseToScaleThenConvert)
+    {
+        const int srcWidth = std::get<0>(GetParam());
+        const int srcHeight = std::get<1>(GetParam());
+        const int width = std::get<2>(GetParam());
+        const int height = std::get<3>(GetParam());
+        auto src = CreateGradient(srcWidth, srcHeight);
+
+        std::vector<uint8_t> expected(static_cast<size_t>(width) * height * 4);
+        ScaleThenConvert(*src, width, height, libyuv::FOURCC_ABGR, expected.data());
+
+        I420ToRGBConverter converter;
+        std::vector<uint8_t> actual(expected.size());
+        EXPECT_TRUE(converter.Convert(*src, width, height, libyuv::FOURCC_ABGR, false, actual.data()));
+        if (width == srcWidth && height == srcHeight)
+            EXPECT_EQ(expected, actual);
+        else
+            EXPECT_LE(MaxDifference(expected, actual), 8);
+    }
+
+    TEST_P(I420ToRGBConverterTest, FlipVertical)
+    {
+        const int srcWidth = std::get<0>(GetParam());
+        const int srcHeight = std::get<1>(GetParam());
+        const int width = std::get<2>(GetParam());
+        const int height = std::get<3>(GetParam());
+        auto src = CreateGradient(srcWidth, srcHeight);
+        const size_t rowSize = static_cast<size_t>(width) * 4;
+
+        I420ToRGBConverter converter;
+        std::vector<uint8_t> upright(rowSize * height);
+        std::vector<uint8_t> flipped(rowSize * height);
+        EXPECT_TRUE(converter.Convert(*src, width, height, libyuv::FOURCC_ARGB, false, upright.data()));
+        EXPECT_TRUE(converter.Convert(*src, width, height, libyuv::FOURCC_ARGB, true, flipped.data()));
+
+        // Filtering may sample the rows a little differently when the image is upside down.
+        std::vector<uint8_t> unflipped(flipped.size());
+        for (int y = 0; y < height; y++)
+            std::memcpy(unflipped.data() + y * rowSize, flipped.data() + (height - 1 - y) * rowSize, rowSize);
+        EXPECT_LE(MaxDifference(upright, unflipped), 8);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(
+        Sizes,
+        I420ToRGBConverterTest,
+        testing::Values(
+            std::make_tuple(320, 240, 320, 240),
+            std::make_tuple(1280, 720, 640, 360),
+            std::make_tuple(640, 360, 1280, 720),
+            std::make_tuple(321, 241, 160, 121)));
+
+    TEST(I420ToRGBConverter, KeepScratchBuffer)
+    {
+        auto src = CreateGradient(1280, 720);
+        std::vector<uint8_t> dst(640 * 360 * 4);
+        I420ToRGBConverter converter;
+        EXPECT_TRUE(converter.Convert(*src, 640, 360, libyuv::FOURCC_ARGB, false, dst.data()));
+        const size_t scratchSize = converter.scratchSize();
+        EXPECT_GT(scratchSize, 0u);
+        EXPECT_TRUE(converter.Convert(*src, 640, 360, libyuv::FOURCC_ARGB, false, dst.data()));
+        EXPECT_EQ(scratchSize, converter.scratchSize());
+    }
+
+    TEST(I420ToRGBConverter, UnsupportedFormat)
+    {
+        auto src = CreateGradient(64, 64);
+        std::vector<uint8_t> dst(64 * 64 * 4);
+        I420ToRGBConverter converter;
+        EXPECT_FALSE(converter.Convert(*src, 64, 64, libyuv::FOURCC_ANY, false, dst.data()));
+    }
+
+    class I420ToRGBConverterBenchmark : public testing::Test
+    {
+    protected:
+        void Measure(const char* name, int srcWidth, int srcHeight)
+        {
+            auto src = CreateGradient(srcWidth, srcHeight);
+            std::vector<uint8_t> dst(static_cast<size_t>(kWidth) * kHeight * 4);
+
+            int64_t start = rtc::TimeNanos();
+            for (int i = 0; i < kFrames; i++)
+                ScaleThenConvert(*src, kWidth, kHeight, libyuv::FOURCC_ABGR, dst.data());
+            const int64_t scaleThenConvertNs = rtc::TimeNanos() - start;
+
+            I420ToRGBConverter converter;
+            start = rtc::TimeNanos();
+            for (int i = 0; i < kFrames; i++)
+                converter.Convert(*src, kWidth, kHeight, libyuv::FOURCC_ABGR, false, dst.data());
+            const int64_t converterNs = rtc::TimeNanos() - start;
+
+            const std::string prefix(name);
+            ReportBenchmark(
+                prefix,
+                { { prefix + "_scale_then_convert_us_per_frame",
+                    static_cast<int>(scaleThenConvertNs / kFrames / 1000) },
+                  { prefix + "_converter_us_per_frame", static_cast<int>(converterNs / kFrames / 1000) } });
+        }
+
+        static constexpr int kWidth = 1920;
+        static constexpr int kHeight = 1080;
+        static constexpr int kFrames = 30;
+    };
+
+    TEST_F(I420ToRGBConverterBenchmark, DISABLED_Upscale720p) { Measure("720p_to_1080p", 1280, 720); }
+
+    TEST_F(I420ToRGBConverterBenchmark, DISABLED_Downscale2160p) { Measure("2160p_to_1080p", 3840, 2160); }
+
+} // end namespace webrtc
+} // end namespace unity
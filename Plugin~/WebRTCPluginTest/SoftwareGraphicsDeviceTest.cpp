@@ -0,0 +1,101 @@
+#include "pch.h"
+
+#include <algorithm>
+
+#include "GraphicsDevice/ITexture2D.h"
+#include "GraphicsDevice/Software/SoftwareGraphicsDevice.h"
+#include "GraphicsDevice/Software/SoftwareTexture2D.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    class SoftwareGraphicsDeviceTest : public testing::Test
+    {
+    public:
+        SoftwareGraphicsDeviceTest()
+            : device_(kUnityGfxRendererNull, nullptr)
+        {
+            EXPECT_TRUE(device_.InitV());
+        }
+        ~SoftwareGraphicsDeviceTest() override { device_.ShutdownV(); }
+
+    protected:
+        SoftwareGraphicsDevice device_;
+        const uint32_t kWidth = 256;
+        const uint32_t kHeight = 256;
+    };
+
+    TEST_F(SoftwareGraphicsDeviceTest, BufferIsAligned)
+    {
+        const UnityRenderingExtTextureFormat format = kUnityRenderingExtFormatB8G8R8A8_UNorm;
+        std::unique_ptr<ITexture2D> tex(device_.CreateDefaultTextureV(kWidth, kHeight, format));
+        ASSERT_NE(tex, nullptr);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(tex->GetNativeTexturePtrV()) % 64);
+    }
+
+    TEST_F(SoftwareGraphicsDeviceTest, ReuseReleasedBuffer)
+    {
+        const UnityRenderingExtTextureFormat format = kUnityRenderingExtFormatB8G8R8A8_UNorm;
+        std::unique_ptr<ITexture2D> tex1(device_.CreateDefaultTextureV(kWidth, kHeight, format));
+        void* ptr1 = tex1->GetNativeTexturePtrV();
+        EXPECT_EQ(0u, device_.pooledBufferCount());
+
+        tex1 = nullptr;
+        EXPECT_EQ(1u, device_.pooledBufferCount());
+
+        std::unique_ptr<ITexture2D> tex2(device_.CreateDefaultTextureV(kWidth, kHeight, format));
+        EXPECT_EQ(ptr1, tex2->GetNativeTexturePtrV());
+        EXPECT_EQ(0u, device_.pooledBufferCount());
+
+        // A different size does not take the pooled buffer.
+        tex2 = nullptr;
+        std::unique_ptr<ITexture2D> tex3(device_.CreateDefaultTextureV(kWidth * 2, kHeight * 2, format));
+        EXPECT_EQ(1u, device_.pooledBufferCount());
+    }
+
+    TEST(SoftwareGraphicsDeviceLifetimeTest, TextureOutlivesDevice)
+    {
+        auto device = std::make_unique<SoftwareGraphicsDevice>(kUnityGfxRendererNull, nullptr);
+        ASSERT_TRUE(device->InitV());
+        std::unique_ptr<ITexture2D> tex(device->CreateDefaultTextureV(16, 16, kUnityRenderingExtFormatB8G8R8A8_UNorm));
+        ASSERT_NE(tex, nullptr);
+        device->ShutdownV();
+        device = nullptr;
+
+        // The buffer is freed directly since the pool has gone with the device.
+        tex = nullptr;
+    }
+
+    TEST_F(SoftwareGraphicsDeviceTest, CopyResourceFromHostMemory)
+    {
+        const UnityRenderingExtTextureFormat format = kUnityRenderingExtFormatR8G8B8A8_UNorm;
+        std::vector<uint8_t> pixels(kWidth * kHeight * SoftwareTexture2D::kBytesPerPixel, 0x7f);
+        std::unique_ptr<ITexture2D> tex(device_.CreateCPUReadTextureV(kWidth, kHeight, format));
+        EXPECT_TRUE(device_.CopyResourceFromNativeV(tex.get(), pixels.data()));
+        EXPECT_TRUE(device_.WaitSync(tex.get()));
+
+        const uint8_t* data = static_cast<const uint8_t*>(tex->GetNativeTexturePtrV());
+        EXPECT_TRUE(std::equal(pixels.begin(), pixels.end(), data));
+        EXPECT_FALSE(device_.CopyResourceFromNativeV(tex.get(), nullptr));
+    }
+
+    TEST_F(SoftwareGraphicsDeviceTest, ConvertRGBToI420)
+    {
+        // Opaque white converts to the maximum luma in BT.601 limited range.
+        const UnityRenderingExtTextureFormat format = kUnityRenderingExtFormatB8G8R8A8_UNorm;
+        std::vector<uint8_t> pixels(kWidth * kHeight * SoftwareTexture2D::kBytesPerPixel, 0xff);
+        std::unique_ptr<ITexture2D> tex(device_.CreateCPUReadTextureV(kWidth, kHeight, format));
+        EXPECT_TRUE(device_.CopyResourceFromNativeV(tex.get(), pixels.data()));
+
+        auto buffer = device_.ConvertRGBToI420(tex.get());
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(static_cast<int>(kWidth), buffer->width());
+        EXPECT_EQ(static_cast<int>(kHeight), buffer->height());
+        EXPECT_EQ(235, buffer->DataY()[0]);
+        EXPECT_EQ(128, buffer->DataU()[0]);
+        EXPECT_EQ(128, buffer->DataV()[0]);
+    }
+
+} // end namespace webrtc
+} // end namespace unity
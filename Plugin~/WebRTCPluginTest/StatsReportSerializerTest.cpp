@@ -0,0 +1,486 @@
+#include "pch.h"
+
+#include <cstring>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include <api/stats/rtcstats_objects.h>
+#include <rtc_base/time_utils.h>
+
+#include "Benchmark.h"
+#include "StatsReportSerializer.h"
+
+namespace unity
+{
+namespace webrtc
+{
+    namespace
+    {
+        using Serializer = StatsReportSerializer;
+
+        // Reads the records of a serialized report.
+        class SerializedReport
+        {
+        public:
+            explicit SerializedReport(const std::vector<uint8_t>& buffer)
+                : buffer_(buffer)
+            {
+                std::memcpy(&header, buffer_.data(), sizeof(header));
+            }
+
+            Serializer::StatsRecord Stats(size_t index) const
+            {
+                return Read<Serializer::StatsRecord>(header.statsOffset + index * sizeof(Serializer::StatsRecord));
+            }
+
+            Serializer::MemberRecord Member(size_t index) const
+            {
+                return Read<Serializer::MemberRecord>(header.memberOffset + index * sizeof(Serializer::MemberRecord));
+            }
+
+            std::string_view String(uint32_t index) const
+            {
+                EXPECT_LT(index, header.stringCount);
+                const size_t offset = header.stringOffset + index * sizeof(Serializer::StringEntry);
+                Serializer::StringEntry entry = Read<Serializer::StringEntry>(offset);
+                EXPECT_EQ('\0', buffer_[header.charsOffset + entry.offset + entry.length]);
+                return std::string_view(
+                    reinterpret_cast<const char*>(buffer_.data() + header.charsOffset + entry.offset), entry.length);
+            }
+
+            // Finds the member named |name| of the stats at |index|.
+            Serializer::MemberRecord Member(size_t index, std::string_view name) const
+            {
+                Serializer::StatsRecord stats = Stats(index);
+                for (uint32_t i = 0; i < stats.memberCount; i++)
+                {
+                    Serializer::MemberRecord member = Member(stats.firstMember + i);
+                    if (String(member.name) == name)
+                        return member;
+                }
+                ADD_FAILURE() << "member " << name << " is not found";
+                return {};
+            }
+
+            template<typename T>
+            T Value(const Serializer::MemberRecord& member) const
+            {
+                T value;
+                std::memcpy(&value, &member.value, sizeof(T));
+                return value;
+            }
+
+            template<typename T>
+            T Data(uint32_t offset) const
+            {
+                return Read<T>(header.dataOffset + offset);
+            }
+
+            Serializer::Header header;
+
+        private:
+            template<typename T>
+            T Read(size_t offset) const
+            {
+                EXPECT_LE(offset + sizeof(T), buffer_.size());
+                T value;
+                std::memcpy(&value, buffer_.data() + offset, sizeof(T));
+                return value;
+            }
+
+            const std::vector<uint8_t>& buffer_;
+        };
+
+        std::vector<uint8_t> Serialize(const RTCStatsReport& report)
+        {
+            Serializer serializer;
+            std::vector<uint8_t> buffer(serializer.Serialize(report));
+            serializer.CopyTo(buffer.data());
+            return buffer;
+        }
+
+        // Adds the stats that one peer connection with an audio and a video transceiver in each direction reports.
+        // Only the bytes sent change with |bytesSent|.
+        void AddPeerStats(RTCStatsReport* report, int peer, int64_t timestampUs, uint64_t bytesSent = 10000)
+        {
+            const Timestamp timestamp = Timestamp::Micros(timestampUs);
+            const std::string prefix = "P" + std::to_string(peer);
+            const char* kinds[] = { "audio", "video" };
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                auto outbound = std::make_unique<RTCOutboundRtpStreamStats>(prefix + "OT" + kinds[i], timestamp);
+                outbound->ssrc = 1000 + i;
+                outbound->kind = kinds[i];
+                outbound->transport_id = prefix + "T";
+                outbound->codec_id = prefix + "C" + kinds[i];
+                outbound->packets_sent = 100 * (i + 1);
+                outbound->bytes_sent = bytesSent * (i + 1);
+                outbound->target_bitrate = 500000.0;
+                outbound->frames_encoded = 30;
+                outbound->quality_limitation_durations =
+                    std::map<std::string, double> { { "none", 1.5 }, { "cpu", 0.5 } };
+                report->AddStats(std::move(outbound));
+
+                auto inbound = std::make_unique<RTCInboundRtpStreamStats>(prefix + "IT" + kinds[i], timestamp);
+                inbound->ssrc = 2000 + i;
+                inbound->kind = kinds[i];
+                inbound->transport_id = prefix + "T";
+                inbound->track_identifier = prefix + "track" + kinds[i];
+                inbound->packets_received = 200 * (i + 1);
+                inbound->bytes_received = 20000 * (i + 1);
+                inbound->jitter = 0.01;
+                inbound->frames_decoded = 60;
+                report->AddStats(std::move(inbound));
+
+                auto codec = std::make_unique<RTCCodecStats>(prefix + "C" + kinds[i], timestamp);
+                codec->payload_type = 96 + i;
+                codec->mime_type = i == 0 ? "audio/opus" : "video/VP8";
+                codec->clock_rate = i == 0 ? 48000 : 90000;
+                report->AddStats(std::move(codec));
+            }
+
+            auto pair = std::make_unique<RTCIceCandidatePairStats>(prefix + "CP", timestamp);
+            pair->transport_id = prefix + "T";
+            pair->state = "succeeded";
+            pair->nominated = true;
+            pair->bytes_sent = bytesSent * 3;
+            pair->current_round_trip_time = 0.02;
+            report->AddStats(std::move(pair));
+
+            auto transport = std::make_unique<RTCTransportStats>(prefix + "T", timestamp);
+            transport->bytes_sent = bytesSent * 3;
+            transport->bytes_received = 60000;
+            transport->dtls_state = "connected";
+            report->AddStats(std::move(transport));
+        }
+
+        char* CopyString(std::string_view str)
+        {
+            char* dst = static_cast<char*>(CoTaskMemAlloc(str.size() + 1));
+            str.copy(dst, str.size());
+            dst[str.size()] = '\0';
+            return dst;
+        }
+
+        template<typename T>
+        T* CopyArray(const T* src, size_t length)
+        {
+            T* dst = static_cast<T*>(CoTaskMemAlloc(sizeof(T) * length));
+            std::memcpy(dst, src, sizeof(T) * length);
+            return dst;
+        }
+
+        // The path of the C API before: ContextGetStatsList, then StatsGetId and StatsGetMembers for each stats, and
+        // StatsMemberGetName and one value accessor for each member. Each call returns memory allocated with
+        // CoTaskMemAlloc which the managed side frees. Returns the number of members read.
+        class MemberCallReader
+        {
+        public:
+            size_t Read(const RTCStatsReport& report)
+            {
+                size_t members = 0;
+                Free(CoTaskMemAlloc(sizeof(uint32_t) * report.size()));
+                Free(CoTaskMemAlloc(sizeof(RTCStats*) * report.size()));
+                for (const RTCStats& stats : report)
+                {
+                    Free(CopyString(stats.id()));
+                    std::vector<Attribute> attributes = stats.Attributes();
+                    Free(CopyArray(attributes.data(), attributes.size()));
+                    for (const Attribute& attribute : attributes)
+                    {
+                        Free(CopyString(attribute.name()));
+                        std::visit(
+                            [this](const auto* value)
+                            {
+                                if (value->has_value())
+                                    ReadValue(value->value());
+                            },
+                            attribute.as_variant());
+                        members++;
+                    }
+                }
+                return members;
+            }
+
+            size_t allocations = 0;
+
+        private:
+            void Free(void* ptr)
+            {
+                allocations++;
+                CoTaskMemFree(ptr);
+            }
+
+            template<typename T>
+            void ReadValue(const T&)
+            {
+            }
+            void ReadValue(const std::string& value) { Free(CopyString(value)); }
+            template<typename T>
+            void ReadValue(const std::vector<T>& values)
+            {
+                Free(CopyArray(values.data(), values.size()));
+            }
+            void ReadValue(const std::vector<bool>& values)
+            {
+                bool* dst = static_cast<bool*>(CoTaskMemAlloc(sizeof(bool) * values.size()));
+                for (size_t i = 0; i < values.size(); i++)
+                    dst[i] = values[i];
+                Free(dst);
+            }
+            void ReadValue(const std::vector<std::string>& values)
+            {
+                for (const std::string& value : values)
+                    Free(CopyString(value));
+                Free(CoTaskMemAlloc(sizeof(char*) * values.size()));
+            }
+            template<typename T>
+            void ReadValue(const std::map<std::string, T>& values)
+            {
+                for (const auto& pair : values)
+                    Free(CopyString(pair.first));
+                Free(CoTaskMemAlloc(sizeof(char*) * values.size()));
+                Free(CoTaskMemAlloc(sizeof(T) * values.size()));
+            }
+        };
+    }
+
+    TEST(StatsReportSerializerTest, WriteEveryStatsAndMember)
+    {
+        auto report = RTCStatsReport::Create(Timestamp::Micros(1234));
+        AddPeerStats(report.get(), 0, 1234);
+
+        std::vector<uint8_t> buffer = Serialize(*report);
+        SerializedReport serialized(buffer);
+        EXPECT_EQ(Serializer::kVersion, serialized.header.version);
+        EXPECT_EQ(buffer.size(), serialized.header.size);
+        ASSERT_EQ(report->size(), serialized.header.statsCount);
+
+        size_t index = 0;
+        for (const RTCStats& stats : *report)
+        {
+            Serializer::StatsRecord record = serialized.Stats(index);
+            EXPECT_EQ(stats.id(), serialized.String(record.id));
+            EXPECT_EQ(std::string_view(stats.type()), serialized.String(record.type));
+            EXPECT_EQ(1234, record.timestamp);
+            EXPECT_EQ(stats.Attributes().size(), record.memberCount);
+            index++;
+        }
+    }
+
+    TEST(StatsReportSerializerTest, WriteMemberValues)
+    {
+        auto report = RTCStatsReport::Create(Timestamp::Micros(0));
+        AddPeerStats(report.get(), 0, 0);
+        std::vector<uint8_t> buffer = Serialize(*report);
+        SerializedReport serialized(buffer);
+
+        size_t outbound = 0;
+        for (const RTCStats& stats : *report)
+        {
+            if (stats.id() == "P0OTvideo")
+                break;
+            outbound++;
+        }
+        ASSERT_LT(outbound, report->size());
+
+        Serializer::MemberRecord ssrc = serialized.Member(outbound, "ssrc");
+        EXPECT_EQ(StatsMemberType::Uint32, ssrc.type);
+        EXPECT_EQ(1, ssrc.defined);
+        EXPECT_EQ(1001u, serialized.Value<uint32_t>(ssrc));
+
+        Serializer::MemberRecord bytesSent = serialized.Member(outbound, "bytesSent");
+        EXPECT_EQ(StatsMemberType::Uint64, bytesSent.type);
+        EXPECT_EQ(20000u, serialized.Value<uint64_t>(bytesSent));
+
+        Serializer::MemberRecord bitrate = serialized.Member(outbound, "targetBitrate");
+        EXPECT_EQ(StatsMemberType::Double, bitrate.type);
+        EXPECT_EQ(500000.0, serialized.Value<double>(bitrate));
+
+        Serializer::MemberRecord kind = serialized.Member(outbound, "kind");
+        EXPECT_EQ(StatsMemberType::String, kind.type);
+        EXPECT_EQ("video", serialized.String(static_cast<uint32_t>(kind.value)));
+
+        Serializer::MemberRecord durations = serialized.Member(outbound, "qualityLimitationDurations");
+        EXPECT_EQ(StatsMemberType::MapStringDouble, durations.type);
+        ASSERT_EQ(2u, durations.count);
+        // The keys are in the order of the map, and the values start at the next multiple of 8 bytes.
+        EXPECT_EQ("cpu", serialized.String(serialized.Data<uint32_t>(durations.offset)));
+        EXPECT_EQ("none", serialized.String(serialized.Data<uint32_t>(durations.offset + 4)));
+        EXPECT_EQ(0.5, serialized.Data<double>(durations.offset + 8));
+        EXPECT_EQ(1.5, serialized.Data<double>(durations.offset + 16));
+
+        Serializer::MemberRecord rid = serialized.Member(outbound, "rid");
+        EXPECT_EQ(StatsMemberType::String, rid.type);
+        EXPECT_EQ(0, rid.defined);
+    }
+
+    TEST(StatsReportSerializerTest, InternRepeatedStrings)
+    {
+        auto report = RTCStatsReport::Create(Timestamp::Micros(0));
+        AddPeerStats(report.get(), 0, 0);
+        AddPeerStats(report.get(), 1, 0);
+        std::vector<uint8_t> buffer = Serialize(*report);
+        SerializedReport serialized(buffer);
+
+        // The stats of both peers share the names of their members and the values which are the same.
+        uint32_t strings = 0;
+        size_t outbound[2] = {};
+        size_t index = 0;
+        for (const RTCStats& stats : *report)
+        {
+            if (stats.id() == "P0OTaudio")
+                outbound[0] = index;
+            if (stats.id() == "P1OTaudio")
+                outbound[1] = index;
+            strings += 1 + static_cast<uint32_t>(stats.Attributes().size());
+            index++;
+        }
+        EXPECT_LT(serialized.header.stringCount, strings / 2);
+        EXPECT_EQ(serialized.Member(outbound[0], "kind").value, serialized.Member(outbound[1], "kind").value);
+        EXPECT_EQ(serialized.Member(outbound[0], "ssrc").name, serialized.Member(outbound[1], "ssrc").name);
+    }
+
+    TEST(StatsReportSerializerTest, SerializeEmptyReport)
+    {
+        auto report = RTCStatsReport::Create(Timestamp::Micros(0));
+        std::vector<uint8_t> buffer = Serialize(*report);
+        SerializedReport serialized(buffer);
+        EXPECT_EQ(sizeof(Serializer::Header), buffer.size());
+        EXPECT_EQ(0u, serialized.header.statsCount);
+        EXPECT_EQ(0u, serialized.header.stringCount);
+    }
+
+    TEST(StatsReportSerializerTest, SelectStatsByTypeAndMemberName)
+    {
+        auto report = RTCStatsReport::Create(Timestamp::Micros(0));
+        AddPeerStats(report.get(), 0, 0);
+
+        StatsReportFilter filter;
+        filter.types = { "outbound-rtp" };
+        filter.members = { "framesEncoded", "bytesSent" };
+        Serializer serializer;
+        std::vector<uint8_t> buffer(serializer.Serialize(*report, filter, nullptr));
+        serializer.CopyTo(buffer.data());
+        SerializedReport serialized(buffer);
+
+        ASSERT_EQ(2u, serialized.header.statsCount);
+        EXPECT_EQ(4u, serialized.header.memberCount);
+        for (size_t i = 0; i < 2; i++)
+        {
+            Serializer::StatsRecord stats = serialized.Stats(i);
+            EXPECT_EQ("outbound-rtp", serialized.String(stats.type));
+            ASSERT_EQ(2u, stats.memberCount);
+            // The members are in the order of the stats, not of the filter.
+            EXPECT_EQ("bytesSent", serialized.String(serialized.Member(stats.firstMember).name));
+            EXPECT_EQ("framesEncoded", serialized.String(serialized.Member(stats.firstMember + 1).name));
+        }
+    }
+
+    TEST(StatsReportSerializerTest, WriteOnlyMembersChangedSincePreviousReport)
+    {
+        auto previous = RTCStatsReport::Create(Timestamp::Micros(0));
+        AddPeerStats(previous.get(), 0, 0, 10000);
+        auto oldCodec = std::make_unique<RTCCodecStats>("P0Cold", Timestamp::Micros(0));
+        oldCodec->payload_type = 101;
+        previous->AddStats(std::move(oldCodec));
+        auto report = RTCStatsReport::Create(Timestamp::Micros(1000000));
+        AddPeerStats(report.get(), 0, 1000000, 15000);
+        auto codec = std::make_unique<RTCCodecStats>("P0Cnew", Timestamp::Micros(1000000));
+        codec->payload_type = 100;
+        codec->mime_type = "video/H264";
+        const size_t codecMembers = codec->Attributes().size();
+        report->AddStats(std::move(codec));
+
+        Serializer serializer;
+        std::vector<uint8_t> buffer(serializer.Serialize(*report, StatsReportFilter(), previous.get()));
+        serializer.CopyTo(buffer.data());
+        SerializedReport serialized(buffer);
+
+        // The stats without any change are left out, and the new stats is written whole.
+        std::map<std::string, std::string> changed;
+        for (size_t i = 0; i < serialized.header.statsCount; i++)
+        {
+            Serializer::StatsRecord stats = serialized.Stats(i);
+            const std::string id(serialized.String(stats.id));
+            if (id == "P0Cnew")
+            {
+                EXPECT_EQ(codecMembers, stats.memberCount);
+                EXPECT_EQ(0u, stats.flags);
+                continue;
+            }
+            // The stats which is not reported any more is written without members.
+            if (id == "P0Cold")
+            {
+                EXPECT_EQ(Serializer::kStatsRemoved, stats.flags);
+                EXPECT_EQ(0u, stats.memberCount);
+                EXPECT_EQ("codec", serialized.String(stats.type));
+                EXPECT_EQ(1000000, stats.timestamp);
+                continue;
+            }
+            ASSERT_EQ(1u, stats.memberCount) << id;
+            EXPECT_EQ(0u, stats.flags) << id;
+            changed[id] = std::string(serialized.String(serialized.Member(stats.firstMember).name));
+        }
+        const std::map<std::string, std::string> expected = {
+            { "P0CP", "bytesSent" }, { "P0OTaudio", "bytesSent" }, { "P0OTvideo", "bytesSent" }, { "P0T", "bytesSent" }
+        };
+        EXPECT_EQ(expected, changed);
+        EXPECT_EQ(6u, serialized.header.statsCount);
+    }
+
+    class StatsReportSerializerBenchmark : public testing::Test
+    {
+    protected:
+        static constexpr int kPeers = 50;
+        static constexpr int kPolls = 100;
+    };
+
+    // Reads the reports of 50 peer connections, as polling their stats once per second does.
+    TEST_F(StatsReportSerializerBenchmark, DISABLED_Read50PeerReports)
+    {
+        std::vector<rtc::scoped_refptr<RTCStatsReport>> reports;
+        for (int i = 0; i < kPeers; i++)
+        {
+            reports.push_back(RTCStatsReport::Create(Timestamp::Micros(0)));
+            AddPeerStats(reports.back().get(), i, 0);
+        }
+
+        MemberCallReader reader;
+        size_t members = 0;
+        int64_t start = rtc::TimeNanos();
+        for (int poll = 0; poll < kPolls; poll++)
+        {
+            for (const auto& report : reports)
+                members += reader.Read(*report);
+        }
+        const int64_t memberCallNs = rtc::TimeNanos() - start;
+
+        Serializer serializer;
+        std::vector<uint8_t> buffer;
+        size_t serializedMembers = 0;
+        start = rtc::TimeNanos();
+        for (int poll = 0; poll < kPolls; poll++)
+        {
+            for (const auto& report : reports)
+            {
+                const size_t size = serializer.Serialize(*report);
+                if (buffer.size() < size)
+                    buffer.resize(size);
+                serializer.CopyTo(buffer.data());
+                serializedMembers += SerializedReport(buffer).header.memberCount;
+            }
+        }
+        const int64_t serializerNs = rtc::TimeNanos() - start;
+        EXPECT_EQ(members, serializedMembers);
+
+        ReportBenchmark(
+            std::to_string(kPeers) + " peers",
+            { { "member_calls_us_per_poll", static_cast<int>(memberCallNs / kPolls / 1000) },
+              { "member_calls_allocations_per_poll", static_cast<int>(reader.allocations / kPolls) },
+              { "serializer_us_per_poll", static_cast<int>(serializerNs / kPolls / 1000) } });
+    }
+
+} // end namespace webrtc
+} // end namespace unity
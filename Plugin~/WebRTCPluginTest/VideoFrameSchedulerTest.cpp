@@ -1,7 +1,12 @@
 #include "pch.h"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "VideoFrameScheduler.h"
 #include <api/task_queue/default_task_queue_factory.h>
+#include <rtc_base/event.h>
 
 namespace unity
 {
@@ -81,12 +86,21 @@ namespace webrtc
             scheduler_->Start(std::bind(&VideoFrameSchedulerTest::CaptureCallback, this));
         }
 
-        void CaptureCallback() { count_++; }
+        void CaptureCallback()
+        {
+            count_++;
+            // Simulates the time spent capturing and reports the result like UnityVideoTrackSource.
+            clock_.AdvanceTime(captureDuration_);
+            scheduler_->OnFrameCaptured(frame_.get());
+        }
 
     protected:
         const int kMaxFramerate = 30;
         const TimeDelta kTimeDelta = TimeDelta::Seconds(1) / kMaxFramerate;
         int count_ = 0;
+        TimeDelta captureDuration_ = TimeDelta::Zero();
+        rtc::scoped_refptr<VideoFrame> frame_ =
+            VideoFrame::WrapExternalGpuMemoryBuffer(Size(16, 16), nullptr, nullptr, TimeDelta::Zero());
         SimulatedClock clock_;
         std::unique_ptr<VideoFrameScheduler> scheduler_;
     };
@@ -137,5 +151,168 @@ namespace webrtc
 
         scheduler_ = nullptr;
     }
+
+    TEST_F(VideoFrameSchedulerTest, ResumeAfterZeroFramerate)
+    {
+        FakeTaskQueue queue(&clock_);
+        InitScheduler(queue);
+
+        // The task stops scheduling captures after it sees a framerate of 0.
+        scheduler_->SetMaxFramerateFps(0);
+        EXPECT_TRUE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+
+        scheduler_->SetMaxFramerateFps(kMaxFramerate);
+        EXPECT_TRUE(queue.IsTaskQueued());
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(2, count_);
+
+        // Resuming after a pause works as well.
+        scheduler_->Pause(true);
+        EXPECT_TRUE(queue.AdvanceTimeAndRunLastTask());
+        scheduler_->Pause(false);
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(3, count_);
+
+        scheduler_ = nullptr;
+    }
+
+    TEST_F(VideoFrameSchedulerTest, RelativePacingDrifts)
+    {
+        FakeTaskQueue queue(&clock_);
+        InitScheduler(queue);
+        const Timestamp start = clock_.CurrentTime();
+
+        // A capture longer than the interval is followed by another one at once.
+        captureDuration_ = kTimeDelta * 3 / 2;
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(TimeDelta::Zero(), queue.last_delay());
+        captureDuration_ = TimeDelta::Zero();
+
+        // The following captures are shifted by half an interval.
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(start + kTimeDelta + kTimeDelta * 3 / 2, clock_.CurrentTime());
+        EXPECT_EQ(kTimeDelta, queue.last_delay());
+
+        scheduler_ = nullptr;
+    }
+
+    TEST_F(VideoFrameSchedulerTest, AbsolutePacingKeepsTimeline)
+    {
+        FakeTaskQueue queue(&clock_);
+        InitScheduler(queue);
+        scheduler_->SetPacing(VideoFrameScheduler::Pacing::Absolute);
+        const Timestamp start = clock_.CurrentTime();
+        captureDuration_ = TimeDelta::Millis(5);
+
+        for (int i = 0; i < 3; i++)
+            EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(3, count_);
+        EXPECT_EQ(start + kTimeDelta * 3 + captureDuration_, clock_.CurrentTime());
+        EXPECT_EQ(kTimeDelta - captureDuration_, queue.last_delay());
+
+        VideoFrameScheduler::Stats stats = scheduler_->GetStats();
+        EXPECT_EQ(3u, stats.framesScheduled);
+        EXPECT_EQ(3u, stats.framesCaptured);
+        EXPECT_EQ(0u, stats.framesLate);
+        EXPECT_EQ(0u, stats.framesSkipped);
+        EXPECT_EQ(captureDuration_, stats.lastCaptureLatency);
+
+        scheduler_ = nullptr;
+    }
+
+    TEST_F(VideoFrameSchedulerTest, AbsolutePacingSkipsMissedSlots)
+    {
+        FakeTaskQueue queue(&clock_);
+        InitScheduler(queue);
+        scheduler_->SetPacing(VideoFrameScheduler::Pacing::Absolute);
+        const Timestamp start = clock_.CurrentTime();
+
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(1, count_);
+
+        // The second capture takes two and a half intervals, so the slots 3 and 4 are missed.
+        captureDuration_ = kTimeDelta * 5 / 2;
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(2, count_);
+        captureDuration_ = TimeDelta::Zero();
+
+        // The next capture waits for slot 5 instead of running at once.
+        EXPECT_GT(queue.last_delay(), TimeDelta::Zero());
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        EXPECT_EQ(3, count_);
+        EXPECT_EQ(start + kTimeDelta * 5, clock_.CurrentTime());
+
+        VideoFrameScheduler::Stats stats = scheduler_->GetStats();
+        EXPECT_EQ(3u, stats.framesScheduled);
+        EXPECT_EQ(3u, stats.framesCaptured);
+        EXPECT_EQ(1u, stats.framesLate);
+        EXPECT_EQ(2u, stats.framesSkipped);
+
+        scheduler_ = nullptr;
+    }
+
+    TEST_F(VideoFrameSchedulerTest, CountFailedCaptures)
+    {
+        FakeTaskQueue queue(&clock_);
+        InitScheduler(queue);
+        frame_ = nullptr;
+
+        EXPECT_FALSE(queue.AdvanceTimeAndRunLastTask());
+        VideoFrameScheduler::Stats stats = scheduler_->GetStats();
+        EXPECT_EQ(1u, stats.framesScheduled);
+        EXPECT_EQ(0u, stats.framesCaptured);
+
+        scheduler_ = nullptr;
+    }
+
+    // Pause and SetMaxFramerateFps are called from several threads while the task runs on a real task queue. Run with
+    // ThreadSanitizer to check for data races.
+    TEST(VideoFrameSchedulerStressTest, ChangeStateFromManyThreads)
+    {
+        const int kThreadCount = 4;
+        const int kIterations = 2000;
+
+        std::unique_ptr<TaskQueueFactory> factory = CreateDefaultTaskQueueFactory();
+        std::unique_ptr<TaskQueueBase, TaskQueueDeleter> queue =
+            factory->CreateTaskQueue("VideoFrameSchedulerStressTest", TaskQueueFactory::Priority::NORMAL);
+
+        std::atomic<int> count(0);
+        auto scheduler = std::make_unique<VideoFrameScheduler>(queue.get());
+        scheduler->SetMaxFramerateFps(1000);
+        scheduler->Start([&count]() { count++; });
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < kThreadCount; i++)
+        {
+            threads.emplace_back(
+                [&scheduler, i]()
+                {
+                    for (int j = 0; j < kIterations; j++)
+                    {
+                        scheduler->Pause((i + j) % 3 == 0);
+                        // A framerate of 0 stops the captures until another value is set.
+                        scheduler->SetMaxFramerateFps((j % 3) * 500);
+                        scheduler->SetPacing(
+                            j % 2 ? VideoFrameScheduler::Pacing::Absolute : VideoFrameScheduler::Pacing::Relative);
+                        scheduler->GetStats();
+                    }
+                });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        // The scheduler keeps capturing after the last resume, even if the last framerate was 0.
+        scheduler->SetMaxFramerateFps(0);
+        scheduler->SetMaxFramerateFps(1000);
+        scheduler->Pause(false);
+        const int countAfterResume = count.load();
+        for (int i = 0; i < 100 && count.load() == countAfterResume; i++)
+            rtc::Event().Wait(TimeDelta::Millis(10));
+        EXPECT_GT(count.load(), countAfterResume);
+
+        scheduler = nullptr;
+        EXPECT_GT(count.load(), 0);
+    }
 }
 }
@@ -1,12 +1,15 @@
 #include "pch.h"
 
+#include <thread>
+#include <vector>
+
 #include "Context.h"
 #include "GraphicsDevice/IGraphicsDevice.h"
 #include "GraphicsDevice/ITexture2D.h"
 #include "GraphicsDeviceTestBase.h"
 #include "UnityVideoRenderer.h"
 #include "UnityVideoTrackSource.h"
-#include <api/task_queue/default_task_queue_factory.h>
+#include "VideoRendererWorkerPool.h"
 
 using testing::_;
 using testing::Invoke;
@@ -19,11 +22,38 @@ namespace webrtc
     const int kWidth = 256;
     const int kHeight = 256;
 
+    // Native buffer which counts the read backs.
+    class FakeNativeBuffer : public webrtc::VideoFrameBuffer
+    {
+    public:
+        FakeNativeBuffer(int width, int height)
+            : width_(width)
+            , height_(height)
+        {
+        }
+        Type type() const override { return Type::kNative; }
+        int width() const override { return width_; }
+        int height() const override { return height_; }
+        rtc::scoped_refptr<webrtc::I420BufferInterface> ToI420() override
+        {
+            toI420Count_++;
+            rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Create(width_, height_);
+            webrtc::I420Buffer::SetBlack(buffer.get());
+            return buffer;
+        }
+        int toI420Count() const { return toI420Count_; }
+
+    private:
+        const int width_;
+        const int height_;
+        std::atomic<int> toI420Count_ { 0 };
+    };
+
     class VideoRendererTest : public GraphicsDeviceTestBase
     {
     public:
         VideoRendererTest()
-            : m_taskQueueFactory(CreateDefaultTaskQueueFactory())
+            : m_workerPool(std::make_shared<VideoRendererWorkerPool>(2))
         {
             m_callback = &OnFrameSizeChange;
             m_renderer = std::make_unique<UnityVideoRenderer>(1, m_callback, true);
@@ -45,7 +75,7 @@ namespace webrtc
         std::unique_ptr<Context> context;
         std::unique_ptr<ITexture2D> m_texture;
 
-        std::unique_ptr<TaskQueueFactory> m_taskQueueFactory;
+        std::shared_ptr<VideoRendererWorkerPool> m_workerPool;
         std::unique_ptr<UnityVideoRenderer> m_renderer;
         DelegateVideoFrameResize m_callback;
 
@@ -78,6 +108,212 @@ namespace webrtc
         EXPECT_NE(nullptr, data);
     }
 
+    TEST_P(VideoRendererTest, ConvertOnWorkerPool)
+    {
+        UnityVideoRenderer renderer(2, m_callback, false, m_workerPool);
+        rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Create(kWidth, kHeight);
+        webrtc::I420Buffer::SetBlack(buffer.get());
+        renderer.OnFrame(::webrtc::VideoFrame::Builder().set_video_frame_buffer(buffer).set_timestamp_us(1).build());
+        EXPECT_TRUE(renderer.WaitIdleForTest());
+
+        // The texture layout is unknown until the first update, which converts the frame on the render thread.
+        auto data = static_cast<uint8_t*>(
+            renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+        ASSERT_NE(nullptr, data);
+        EXPECT_EQ(0, data[0]);
+        EXPECT_TRUE(renderer.WaitIdleForTest());
+
+        // A white frame is converted as soon as it arrives.
+        buffer = webrtc::I420Buffer::Create(kWidth, kHeight);
+        webrtc::I420Buffer::SetBlack(buffer.get());
+        memset(buffer->MutableDataY(), 235, buffer->StrideY() * kHeight);
+        renderer.OnFrame(::webrtc::VideoFrame::Builder().set_video_frame_buffer(buffer).set_timestamp_us(2).build());
+        EXPECT_TRUE(renderer.WaitIdleForTest());
+
+        auto converted = static_cast<uint8_t*>(
+            renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+        ASSERT_NE(nullptr, converted);
+        EXPECT_NE(data, converted);
+        EXPECT_EQ(255, converted[0]);
+
+        // Without a new frame the same buffer is handed back.
+        EXPECT_EQ(
+            converted, renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+
+        // A resolution change shows the latest frame rather than an empty texture.
+        auto resized = static_cast<uint8_t*>(
+            renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth / 2, kHeight / 2, libyuv::FOURCC_ARGB));
+        ASSERT_NE(nullptr, resized);
+        EXPECT_EQ(255, resized[0]);
+    }
+
+    TEST_P(VideoRendererTest, SkipTextureUpdateBeforeFirstFrame)
+    {
+        UnityVideoRenderer renderer(6, m_callback, false, m_workerPool);
+        EXPECT_EQ(nullptr, renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+        EXPECT_EQ(
+            nullptr, m_renderer->ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+    }
+
+    TEST_P(VideoRendererTest, KeepNativeBufferUntilConverted)
+    {
+        UnityVideoRenderer renderer(3, m_callback, false, m_workerPool);
+        auto buffer = rtc::make_ref_counted<FakeNativeBuffer>(kWidth, kHeight);
+        for (int i = 1; i <= 3; i++)
+        {
+            renderer.OnFrame(
+                ::webrtc::VideoFrame::Builder().set_video_frame_buffer(buffer).set_timestamp_us(i).build());
+        }
+        EXPECT_TRUE(renderer.WaitIdleForTest());
+
+        // Nothing has asked for the pixels yet.
+        EXPECT_EQ(0, buffer->toI420Count());
+        EXPECT_EQ(buffer.get(), renderer.GetFrameBuffer().get());
+
+        EXPECT_NE(nullptr, renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+        EXPECT_TRUE(renderer.WaitIdleForTest());
+        EXPECT_GT(buffer->toI420Count(), 0);
+    }
+
+    TEST_P(VideoRendererTest, ReadBackOnlyRenderedNativeBuffer)
+    {
+        UnityVideoRenderer renderer(7, m_callback, false, m_workerPool);
+        // The texture layout is known before the frames arrive.
+        EXPECT_EQ(nullptr, renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+
+        std::vector<rtc::scoped_refptr<FakeNativeBuffer>> buffers;
+        for (int i = 1; i <= 3; i++)
+        {
+            buffers.push_back(rtc::make_ref_counted<FakeNativeBuffer>(kWidth, kHeight));
+            renderer.OnFrame(
+                ::webrtc::VideoFrame::Builder().set_video_frame_buffer(buffers.back()).set_timestamp_us(i).build());
+            EXPECT_TRUE(renderer.WaitIdleForTest());
+        }
+        for (const auto& buffer : buffers)
+            EXPECT_EQ(0, buffer->toI420Count());
+
+        // Only the frame taken by the texture update is read back.
+        EXPECT_NE(nullptr, renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+        EXPECT_EQ(0, buffers[0]->toI420Count());
+        EXPECT_EQ(0, buffers[1]->toI420Count());
+        EXPECT_EQ(1, buffers[2]->toI420Count());
+        EXPECT_EQ(2u, renderer.GetStats().framesOverwritten);
+    }
+
+    TEST_P(VideoRendererTest, CountOverwrittenAndRenderedFrames)
+    {
+        for (int i = 1; i <= 3; i++)
+            m_renderer->OnFrame(CreateBlackFrameBuilder(kWidth, kHeight).set_timestamp_us(i).build());
+        EXPECT_NE(
+            nullptr, m_renderer->ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+
+        // The same frame is not counted twice.
+        EXPECT_NE(
+            nullptr, m_renderer->ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+
+        UnityVideoRenderer::Stats stats = m_renderer->GetStats();
+        EXPECT_EQ(3u, stats.framesReceived);
+        EXPECT_EQ(1u, stats.framesRendered);
+        EXPECT_EQ(2u, stats.framesOverwritten);
+        uint64_t histogramCount = 0;
+        for (uint64_t count : stats.latencyHistogram)
+            histogramCount += count;
+        EXPECT_EQ(stats.framesRendered, histogramCount);
+    }
+
+    TEST_P(VideoRendererTest, DeliverFramesWhileRendering)
+    {
+        const int kFrameCount = 500;
+
+        UnityVideoRenderer renderer(5, m_callback, false, m_workerPool);
+        rtc::scoped_refptr<webrtc::I420Buffer> buffers[2];
+        for (int i = 0; i < 2; i++)
+        {
+            buffers[i] = webrtc::I420Buffer::Create(kWidth, kHeight);
+            webrtc::I420Buffer::SetBlack(buffers[i].get());
+            if (i == 1)
+                memset(buffers[i]->MutableDataY(), 235, buffers[i]->StrideY() * kHeight);
+        }
+        // The texture layout is known before the first frame.
+        renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB);
+        EXPECT_TRUE(renderer.WaitIdleForTest());
+
+        std::atomic<bool> producing(true);
+        std::thread producer(
+            [&]()
+            {
+                for (int i = 1; i <= kFrameCount; i++)
+                {
+                    renderer.OnFrame(::webrtc::VideoFrame::Builder()
+                                         .set_video_frame_buffer(buffers[i % 2])
+                                         .set_timestamp_us(i)
+                                         .build());
+                }
+                producing = false;
+            });
+
+        // A converted frame is never written while it is handed to Unity, so the first and the last pixel match.
+        int tornFrames = 0;
+        std::thread consumer(
+            [&]()
+            {
+                const size_t lastPixel = kWidth * kHeight * 4 - 4;
+                while (producing)
+                {
+                    auto data = static_cast<uint8_t*>(
+                        renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+                    if (data && data[0] != data[lastPixel])
+                        tornFrames++;
+                    renderer.GetStats();
+                }
+            });
+        producer.join();
+        consumer.join();
+        EXPECT_EQ(0, tornFrames);
+
+        EXPECT_TRUE(renderer.WaitIdleForTest());
+        renderer.ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB);
+
+        // Every frame is either rendered or replaced by a newer one.
+        UnityVideoRenderer::Stats stats = renderer.GetStats();
+        EXPECT_EQ(static_cast<uint64_t>(kFrameCount), stats.framesReceived);
+        EXPECT_EQ(stats.framesReceived, stats.framesRendered + stats.framesOverwritten);
+        EXPECT_GT(stats.framesRendered, 0u);
+    }
+
+    TEST_P(VideoRendererTest, ShareOneWorkerBetweenRenderers)
+    {
+        const int kRendererCount = 4;
+
+        auto workerPool = std::make_shared<VideoRendererWorkerPool>(1);
+        std::vector<std::unique_ptr<UnityVideoRenderer>> renderers;
+        for (int i = 0; i < kRendererCount; i++)
+        {
+            renderers.push_back(std::make_unique<UnityVideoRenderer>(10 + i, m_callback, false, workerPool));
+            renderers[i]->ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB);
+        }
+
+        rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Create(kWidth, kHeight);
+        webrtc::I420Buffer::SetBlack(buffer.get());
+        memset(buffer->MutableDataY(), 235, buffer->StrideY() * kHeight);
+        for (auto& renderer : renderers)
+        {
+            renderer->OnFrame(
+                ::webrtc::VideoFrame::Builder().set_video_frame_buffer(buffer).set_timestamp_us(1).build());
+        }
+        // A renderer can be destroyed while its conversion is posted or running.
+        renderers.pop_back();
+
+        for (auto& renderer : renderers)
+        {
+            EXPECT_TRUE(renderer->WaitIdleForTest());
+            auto data = static_cast<uint8_t*>(
+                renderer->ConvertVideoFrameToTextureAndWriteToBuffer(kWidth, kHeight, libyuv::FOURCC_ARGB));
+            ASSERT_NE(nullptr, data);
+            EXPECT_EQ(255, data[0]);
+        }
+    }
+
     INSTANTIATE_TEST_SUITE_P(GfxDeviceAndColorSpece, VideoRendererTest, testing::ValuesIn(VALUES_TEST_ENV));
 
 } // end namespace webrtc
@@ -373,14 +373,15 @@ namespace Unity.WebRTC
             }
         }
 
-        static void ProcessAudio(AudioTrackSource source, IntPtr array, int sampleRate, int channels, int frames)
+        static void ProcessAudio(AudioTrackSource source, IntPtr array, int sampleRate, int channels, int length)
         {
-            if (sampleRate == 0 || channels == 0 || frames == 0)
+            // The samples of the channels are interleaved, so the length must be a multiple of the channel count.
+            if (sampleRate == 0 || channels == 0 || length == 0 || length % channels != 0)
                 throw new ArgumentException($"arguments are invalid values " +
                     $"sampleRate={sampleRate}, " +
                     $"channels={channels}, " +
-                    $"frames={frames}");
-            source.Update(array, sampleRate, channels, frames);
+                    $"length={length}");
+            source.Update(array, sampleRate, channels, length / channels);
         }
 
         /// <summary>
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.Runtime.InteropServices;
 using System.Threading;
 using UnityEngine;
@@ -123,6 +124,83 @@ namespace Unity.WebRTC
         }
     }
 
+    internal class RendererBatch
+    {
+        [StructLayout(LayoutKind.Sequential)]
+        public struct RendererBatchData
+        {
+            public int renderersCount;
+            public IntPtr rendererIds;
+        }
+
+        private readonly List<Texture> textures = new List<Texture>();
+        private int[] rendererIds = new int[0];
+        private IntPtr idsPtr;
+        private bool submitted;
+        public IntPtr ptr;
+
+        public RendererBatch()
+        {
+            ptr = Marshal.AllocHGlobal(Marshal.SizeOf(typeof(RendererBatchData)));
+        }
+
+        ~RendererBatch()
+        {
+            this.Dispose();
+        }
+
+        public void Dispose()
+        {
+            if (idsPtr != IntPtr.Zero)
+            {
+                Marshal.FreeHGlobal(idsPtr);
+                idsPtr = IntPtr.Zero;
+            }
+            if (ptr != IntPtr.Zero)
+            {
+                Marshal.FreeHGlobal(ptr);
+                ptr = IntPtr.Zero;
+            }
+        }
+
+        public void Add(uint rendererId, Texture texture)
+        {
+            int count = textures.Count;
+            if (count == rendererIds.Length)
+            {
+                const int roundedCapacity = 32;
+                Array.Resize(ref rendererIds, count + roundedCapacity);
+                idsPtr = idsPtr == IntPtr.Zero
+                    ? Marshal.AllocHGlobal(sizeof(int) * rendererIds.Length)
+                    : Marshal.ReAllocHGlobal(idsPtr, (IntPtr)(sizeof(int) * rendererIds.Length));
+            }
+            rendererIds[count] = unchecked((int)rendererId);
+            textures.Add(texture);
+        }
+
+        /// <summary>
+        /// Issues one event which looks up all the renderers, followed by the texture updates of the renderers.
+        /// An empty batch is issued once after a submitted one, so the plugin releases the renderers it looked up.
+        /// </summary>
+        public void Submit()
+        {
+            int count = textures.Count;
+            if (count == 0 && !submitted)
+                return;
+            submitted = count > 0;
+
+            if (count > 0)
+                Marshal.Copy(rendererIds, 0, idsPtr, count);
+            var data = new RendererBatchData { renderersCount = count, rendererIds = idsPtr };
+            Marshal.StructureToPtr(data, ptr, false);
+            WebRTC.Context.BatchRendererUpdate(ptr);
+
+            for (int i = 0; i < count; i++)
+                WebRTC.Context.UpdateRendererTexture(unchecked((uint)rendererIds[i]), textures[i]);
+            textures.Clear();
+        }
+    }
+
     internal class Context : IDisposable
     {
         internal IntPtr self;
@@ -135,8 +213,11 @@ namespace Unity.WebRTC
         private IntPtr batchUpdateFunction;
         private int batchUpdateEventID = -1;
         private IntPtr textureUpdateFunction;
+        private IntPtr batchRendererUpdateFunction;
+        private int batchRendererUpdateEventID = -1;
 
         internal Batch batch;
+        internal RendererBatch rendererBatch;
 
         public static Context Create(int id = 0)
         {
@@ -155,6 +236,7 @@ namespace Unity.WebRTC
             this.id = id;
             this.table = new WeakReferenceTable();
             this.batch = new Batch();
+            this.rendererBatch = new RendererBatch();
         }
 
         ~Context()
@@ -184,6 +266,9 @@ namespace Unity.WebRTC
 
                 NativeMethods.ContextDestroy(id);
                 self = IntPtr.Zero;
+
+                // Freed after the context, so the plugin no longer reads the renderer batch.
+                rendererBatch.Dispose();
             }
             this.disposed = true;
             GC.SuppressFinalize(this);
@@ -270,6 +355,31 @@ namespace Unity.WebRTC
         {
             NativeMethods.DataChannelRegisterOnError(self, channel, callback);
         }
+        public void DataChannelRegisterOnBufferedAmountLow(IntPtr channel, DelegateNativeOnBufferedAmountLow callback)
+        {
+            NativeMethods.DataChannelRegisterOnBufferedAmountLow(self, channel, callback);
+        }
+        public void DataChannelSetBufferedAmountLowThreshold(IntPtr channel, ulong threshold)
+        {
+            NativeMethods.DataChannelSetBufferedAmountLowThreshold(self, channel, threshold);
+        }
+        public int DataChannelSendBatch(IntPtr channel, RTCDataChannelSpan[] messages, int count)
+        {
+            return NativeMethods.DataChannelSendBatch(self, channel, messages, count);
+        }
+        // Returns the queue handle which DataChannelReceiveMessages and DataChannelReleaseMessages take.
+        public IntPtr DataChannelSetQueuedDelivery(IntPtr channel, bool enabled)
+        {
+            return NativeMethods.DataChannelSetQueuedDelivery(self, channel, enabled);
+        }
+        public int DataChannelReceiveMessages(IntPtr queue, DataChannelMessageView[] views)
+        {
+            return NativeMethods.DataChannelReceiveMessages(queue, views, views.Length);
+        }
+        public void DataChannelReleaseMessages(IntPtr queue)
+        {
+            NativeMethods.DataChannelReleaseMessages(queue);
+        }
         public IntPtr CreateMediaStream(string label)
         {
             return NativeMethods.ContextCreateMediaStream(self, label);
@@ -320,6 +430,16 @@ namespace Unity.WebRTC
             return NativeMethods.GetUpdateTextureFunc(self);
         }
 
+        public IntPtr GetBatchRendererUpdateEventFunc()
+        {
+            return NativeMethods.GetBatchRendererUpdateEventFunc(self);
+        }
+
+        public int GetBatchRendererUpdateEventID()
+        {
+            return NativeMethods.GetBatchRendererUpdateEventID();
+        }
+
         public IntPtr CreateVideoTrackSource()
         {
             return NativeMethods.ContextCreateVideoTrackSource(self);
@@ -361,6 +481,27 @@ namespace Unity.WebRTC
             return NativeMethods.ContextGetStatsList(self, report, out length, ref types);
         }
 
+        // Writes the whole report to the buffer if it is large enough, and returns the size of the report in bytes.
+        public ulong SerializeStatsReport(IntPtr report, byte[] buffer)
+        {
+            ulong capacity = buffer == null ? 0 : (ulong)buffer.Length;
+            return NativeMethods.ContextSerializeStatsReport(self, report, buffer, capacity);
+        }
+
+        // Same as SerializeStatsReport, but only with the stats of the types and the members of the names. When the
+        // previous report is given, only the members which changed since it are written, and the stats which are not
+        // in the report any more are written as removed.
+        public ulong SerializeStatsReport(
+            IntPtr report, IntPtr previous, RTCStatsType[] types, string[] members, byte[] buffer)
+        {
+            uint[] typeIds = types == null ? null : Array.ConvertAll(types, type => (uint)type);
+            ulong typesLength = typeIds == null ? 0 : (ulong)typeIds.Length;
+            ulong membersLength = members == null ? 0 : (ulong)members.Length;
+            ulong capacity = buffer == null ? 0 : (ulong)buffer.Length;
+            return NativeMethods.ContextSerializeStatsReportFiltered(
+                self, report, previous, typeIds, typesLength, members, membersLength, buffer, capacity);
+        }
+
         public void DeleteStatsReport(IntPtr report)
         {
             NativeMethods.ContextDeleteStatsReport(self, report);
@@ -383,6 +524,17 @@ namespace Unity.WebRTC
             VideoUpdateMethods.BatchUpdate(batchUpdateFunction, batchUpdateEventID, batchData);
         }
 
+        internal void BatchRendererUpdate(IntPtr batchData)
+        {
+            batchRendererUpdateFunction = batchRendererUpdateFunction == IntPtr.Zero
+                ? GetBatchRendererUpdateEventFunc()
+                : batchRendererUpdateFunction;
+            batchRendererUpdateEventID = batchRendererUpdateEventID == -1
+                ? GetBatchRendererUpdateEventID()
+                : batchRendererUpdateEventID;
+            VideoUpdateMethods.BatchUpdate(batchRendererUpdateFunction, batchRendererUpdateEventID, batchData);
+        }
+
         internal void UpdateRendererTexture(uint rendererId, UnityEngine.Texture texture)
         {
             textureUpdateFunction = textureUpdateFunction == IntPtr.Zero ? GetUpdateTextureFunc() : textureUpdateFunction;
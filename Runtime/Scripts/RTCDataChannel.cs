@@ -76,6 +76,45 @@ namespace Unity.WebRTC
         }
     }
 
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct DataChannelMessageView
+    {
+        public IntPtr data;
+        public int size;
+        public int binary;
+    }
+
+    /// <summary>
+    /// Refers to the content of a message sent by <see cref="RTCDataChannel.SendBatch(RTCDataChannelSpan[], int)"/>.
+    /// </summary>
+    /// <remarks>
+    /// The memory is only read during the call, so it can be reused as soon as the call returns.
+    /// </remarks>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RTCDataChannelSpan
+    {
+        /// <summary>
+        /// Pointer to the content of the message.
+        /// </summary>
+        public IntPtr data;
+
+        /// <summary>
+        /// Length of the message in bytes.
+        /// </summary>
+        public int length;
+
+        /// <summary>
+        /// Creates a span referring to <paramref name="length"/> bytes at <paramref name="data"/>.
+        /// </summary>
+        /// <param name="data">Pointer to the content of the message.</param>
+        /// <param name="length">Length of the message in bytes.</param>
+        public RTCDataChannelSpan(IntPtr data, int length)
+        {
+            this.data = data;
+            this.length = length;
+        }
+    }
+
     /// <summary>
     /// Represents the method that will be invoked when the data channel is successfully opened and ready for communication.
     /// </summary>
@@ -180,6 +219,17 @@ namespace Unity.WebRTC
     /// </example>
     public delegate void DelegateOnMessage(byte[] bytes);
 
+    /// <summary>
+    /// Delegate to be called with each message taken by <see cref="RTCDataChannel.DispatchQueuedMessages(DelegateOnMessagePtr)"/>.
+    /// </summary>
+    /// <remarks>
+    /// The memory of the message is owned by the data channel and is only valid during the call.
+    /// Copy the data to keep it.
+    /// </remarks>
+    /// <param name="data">Pointer to the content of the message.</param>
+    /// <param name="length">Length of the message in bytes.</param>
+    public delegate void DelegateOnMessagePtr(IntPtr data, int length);
+
     /// <summary>
     /// Represents the method that will be invoked when a new data channel is added to the RTCPeerConnection.
     /// </summary>
@@ -255,6 +305,16 @@ namespace Unity.WebRTC
 
     public delegate void DelegateOnError(RTCError error);
 
+    /// <summary>
+    /// Represents the method that will be invoked when the buffered amount of the data channel falls to its threshold.
+    /// </summary>
+    /// <remarks>
+    /// This delegate is typically assigned to the <see cref="RTCDataChannel.OnBufferedAmountLow"/> property.
+    /// </remarks>
+    /// <seealso cref="RTCDataChannel.OnBufferedAmountLow"/>
+    /// <seealso cref="RTCDataChannel.BufferedAmountLowThreshold"/>
+    public delegate void DelegateOnBufferedAmountLow();
+
     /// <summary>
     /// Creates a new RTCDataChannel for peer-to-peer data exchange, using the specified label and options.
     /// </summary>
@@ -290,6 +350,16 @@ namespace Unity.WebRTC
         private DelegateOnOpen onOpen;
         private DelegateOnClose onClose;
         private DelegateOnError onError;
+        private DelegateOnBufferedAmountLow onBufferedAmountLow;
+        private ulong bufferedAmountLowThreshold;
+        private bool queuedDelivery;
+        // Handle of the native message queue, looked up once when QueuedDelivery is set.
+        private IntPtr messageQueue;
+        // Held while the queue is used, so that Dispose does not delete it under a dispatch on another thread.
+        private readonly object messageQueueLock = new object();
+        private DataChannelMessageView[] messageViews;
+
+        const int MessageBatchSize = 64;
 
         /// <summary>
         /// Delegate to be called when a message has been received from the remote peer.
@@ -658,6 +728,199 @@ namespace Unity.WebRTC
         /// </example>
         public ulong BufferedAmount => NativeMethods.DataChannelGetBufferedAmount(GetSelfOrThrow());
 
+        /// <summary>
+        /// Specifies the number of bytes of buffered outgoing data that is considered "low".
+        /// </summary>
+        /// <remarks>
+        /// When <see cref="BufferedAmount"/> decreases from above this threshold to equal or below it, <see cref="OnBufferedAmountLow"/> is called.
+        /// The default value is 0.
+        /// </remarks>
+        /// <example>
+        ///     <code lang="cs"><![CDATA[
+        ///         using System.Collections.Generic;
+        ///         using UnityEngine;
+        ///         using Unity.WebRTC;
+        ///
+        ///         public class DataChannelFlowControlExample : MonoBehaviour
+        ///         {
+        ///             private const ulong MaxBufferedAmount = 1024 * 1024;
+        ///             private RTCDataChannel dataChannel;
+        ///             private Queue<byte[]> pending = new Queue<byte[]>();
+        ///
+        ///             private void Start()
+        ///             {
+        ///                 var peerConnection = new RTCPeerConnection();
+        ///                 dataChannel = peerConnection.CreateDataChannel("test channel", new RTCDataChannelInit());
+        ///                 dataChannel.BufferedAmountLowThreshold = MaxBufferedAmount / 2;
+        ///                 dataChannel.OnBufferedAmountLow = SendPending;
+        ///             }
+        ///
+        ///             public void Enqueue(byte[] message)
+        ///             {
+        ///                 pending.Enqueue(message);
+        ///                 SendPending();
+        ///             }
+        ///
+        ///             private void SendPending()
+        ///             {
+        ///                 while (pending.Count > 0 && dataChannel.BufferedAmount < MaxBufferedAmount)
+        ///                 {
+        ///                     dataChannel.Send(pending.Dequeue());
+        ///                 }
+        ///             }
+        ///         }
+        ///     ]]></code>
+        /// </example>
+        /// <seealso cref="OnBufferedAmountLow"/>
+        public ulong BufferedAmountLowThreshold
+        {
+            get => bufferedAmountLowThreshold;
+            set
+            {
+                WebRTC.Context.DataChannelSetBufferedAmountLowThreshold(GetSelfOrThrow(), value);
+                bufferedAmountLowThreshold = value;
+            }
+        }
+
+        /// <summary>
+        /// Delegate to be called when <see cref="BufferedAmount"/> falls to <see cref="BufferedAmountLowThreshold"/> or below.
+        /// </summary>
+        /// <remarks>
+        /// The delegate is called on the main thread after the buffered data has been sent,
+        /// so the application can queue more data instead of buffering an unbounded amount of it in the data channel.
+        /// </remarks>
+        /// <seealso cref="BufferedAmountLowThreshold"/>
+        public DelegateOnBufferedAmountLow OnBufferedAmountLow
+        {
+            get => onBufferedAmountLow;
+            set
+            {
+                // The native callback is only registered while a delegate is set, so channels without it are not
+                // called back on every change of the buffered amount.
+                if ((onBufferedAmountLow == null) != (value == null))
+                {
+                    DelegateNativeOnBufferedAmountLow callback = null;
+                    if (value != null)
+                        callback = DataChannelNativeOnBufferedAmountLow;
+                    WebRTC.Context.DataChannelRegisterOnBufferedAmountLow(GetSelfOrThrow(), callback);
+                }
+                onBufferedAmountLow = value;
+            }
+        }
+
+        /// <summary>
+        /// Specifies whether the received messages are queued instead of being passed to <see cref="OnMessage"/> as they arrive.
+        /// </summary>
+        /// <remarks>
+        /// By default, each message is copied and passed to <see cref="OnMessage"/> through the main thread as soon as it is received.
+        /// When `QueuedDelivery` is true, the messages are kept in a queue without being copied,
+        /// and <see cref="DispatchQueuedMessages()"/> takes them in batches on the thread which calls it.
+        /// This avoids a callback for every message, and a slow message handler does not hold up the network thread.
+        /// The messages received before `QueuedDelivery` is set to false stay in the queue until they are dispatched.
+        /// </remarks>
+        /// <example>
+        ///     <code lang="cs"><![CDATA[
+        ///         using UnityEngine;
+        ///         using Unity.WebRTC;
+        ///
+        ///         public class DataChannelQueuedDeliveryExample : MonoBehaviour
+        ///         {
+        ///             private RTCDataChannel dataChannel;
+        ///
+        ///             private void Start()
+        ///             {
+        ///                 var peerConnection = new RTCPeerConnection();
+        ///                 dataChannel = peerConnection.CreateDataChannel("test channel", new RTCDataChannelInit());
+        ///                 dataChannel.OnMessage = bytes => Debug.Log("Received " + bytes.Length + " bytes.");
+        ///                 dataChannel.QueuedDelivery = true;
+        ///             }
+        ///
+        ///             private void Update()
+        ///             {
+        ///                 dataChannel.DispatchQueuedMessages();
+        ///             }
+        ///         }
+        ///     ]]></code>
+        /// </example>
+        public bool QueuedDelivery
+        {
+            get => queuedDelivery;
+            set
+            {
+                lock (messageQueueLock)
+                {
+                    messageQueue = WebRTC.Context.DataChannelSetQueuedDelivery(GetSelfOrThrow(), value);
+                }
+                queuedDelivery = value;
+            }
+        }
+
+        /// <summary>
+        /// Passes every queued message to <see cref="OnMessage"/> on the calling thread.
+        /// </summary>
+        /// <remarks>
+        /// The messages are only queued while <see cref="QueuedDelivery"/> is true.
+        /// </remarks>
+        /// <returns>The number of messages dispatched.</returns>
+        public int DispatchQueuedMessages()
+        {
+            return DispatchQueuedMessages(null);
+        }
+
+        /// <summary>
+        /// Passes every queued message to the delegate on the calling thread without copying it.
+        /// </summary>
+        /// <remarks>
+        /// The messages are taken in batches, and the memory of each batch is released after the delegate has been called for all of its messages.
+        /// If the delegate is null, a copy of each message is passed to <see cref="OnMessage"/> instead.
+        /// </remarks>
+        /// <param name="onMessagePtr">Delegate to be called with each message.</param>
+        /// <returns>The number of messages dispatched.</returns>
+        public int DispatchQueuedMessages(DelegateOnMessagePtr onMessagePtr)
+        {
+            GetSelfOrThrow();
+            lock (messageQueueLock)
+            {
+                // Nothing has been queued if QueuedDelivery has never been set, or the channel has been disposed.
+                if (messageQueue == IntPtr.Zero)
+                    return 0;
+                if (messageViews == null)
+                    messageViews = new DataChannelMessageView[MessageBatchSize];
+
+                int total = 0;
+                int count;
+                do
+                {
+                    count = WebRTC.Context.DataChannelReceiveMessages(messageQueue, messageViews);
+                    try
+                    {
+                        // A delegate which disposes the channel deletes the queue with the rest of the batch.
+                        for (int i = 0; i < count && messageQueue != IntPtr.Zero; i++)
+                        {
+                            DataChannelMessageView view = messageViews[i];
+                            if (onMessagePtr != null)
+                            {
+                                onMessagePtr(view.data, view.size);
+                            }
+                            else if (onMessage != null)
+                            {
+                                byte[] bytes = new byte[view.size];
+                                Marshal.Copy(view.data, bytes, 0, view.size);
+                                onMessage(bytes);
+                            }
+                        }
+                    }
+                    finally
+                    {
+                        if (messageQueue != IntPtr.Zero)
+                            WebRTC.Context.DataChannelReleaseMessages(messageQueue);
+                    }
+                    total += count;
+                } while (count == messageViews.Length && messageQueue != IntPtr.Zero);
+                return total;
+            }
+        }
+
         /// <summary>
         /// Indicates whether the RTCDataChannel's connection is negotiated by the Web app or by the WebRTC layer.
         /// </summary>
@@ -789,6 +1052,18 @@ namespace Unity.WebRTC
             });
         }
 
+        [AOT.MonoPInvokeCallback(typeof(DelegateNativeOnBufferedAmountLow))]
+        static void DataChannelNativeOnBufferedAmountLow(IntPtr ptr, ulong bufferedAmount)
+        {
+            WebRTC.Sync(ptr, () =>
+            {
+                if (WebRTC.Table[ptr] is RTCDataChannel channel)
+                {
+                    channel.onBufferedAmountLow?.Invoke();
+                }
+            });
+        }
+
 
         internal RTCDataChannel(IntPtr ptr, RTCPeerConnection peerConnection)
             : base(ptr)
@@ -870,7 +1145,12 @@ namespace Unity.WebRTC
             if (self != IntPtr.Zero && !WebRTC.Context.IsNull)
             {
                 Close();
-                WebRTC.Context.DeleteDataChannel(self);
+                // The queue is deleted with the channel, so a dispatch on another thread has to finish first.
+                lock (messageQueueLock)
+                {
+                    messageQueue = IntPtr.Zero;
+                    WebRTC.Context.DeleteDataChannel(self);
+                }
                 WebRTC.Table.Remove(self);
             }
             base.Dispose();
@@ -1401,6 +1681,59 @@ namespace Unity.WebRTC
             }
         }
 
+        /// <summary>
+        /// Sends several binary messages across the data channel to the remote peer with a single call.
+        /// </summary>
+        /// <remarks>
+        /// The messages are sent in order, as if <see cref="Send(IntPtr, int)"/> was called for each of them.
+        /// Sending stops at the first message the data channel refuses, for example because it has been closed.
+        /// </remarks>
+        /// <exception cref="InvalidOperationException">
+        /// Thrown when the <see cref="ReadyState"/> is not <b>Open</b>.
+        /// </exception>
+        /// <param name="messages">The messages to send.</param>
+        /// <param name="count">The number of messages to send from the start of <paramref name="messages"/>.</param>
+        /// <returns>The number of messages sent.</returns>
+        /// <example>
+        ///     <code lang="cs"><![CDATA[
+        ///         using Unity.Collections;
+        ///         using Unity.Collections.LowLevel.Unsafe;
+        ///         using Unity.WebRTC;
+        ///
+        ///         public class DataChannelSendBatchExample
+        ///         {
+        ///             private RTCDataChannelSpan[] spans = new RTCDataChannelSpan[256];
+        ///
+        ///             public unsafe int SendUpdates(RTCDataChannel dataChannel, NativeArray<byte> buffer, int[] lengths, int count)
+        ///             {
+        ///                 byte* ptr = (byte*)buffer.GetUnsafeReadOnlyPtr();
+        ///                 int offset = 0;
+        ///                 for (int i = 0; i < count; i++)
+        ///                 {
+        ///                     spans[i] = new RTCDataChannelSpan(new System.IntPtr(ptr + offset), lengths[i]);
+        ///                     offset += lengths[i];
+        ///                 }
+        ///                 return dataChannel.SendBatch(spans, count);
+        ///             }
+        ///         }
+        ///     ]]></code>
+        /// </example>
+        /// <seealso cref="RTCDataChannel.ReadyState"/>
+        public int SendBatch(RTCDataChannelSpan[] messages, int count)
+        {
+            if (messages == null)
+                throw new ArgumentNullException(nameof(messages));
+            if (count < 0 || count > messages.Length)
+                throw new ArgumentOutOfRangeException(nameof(count));
+            if (ReadyState != RTCDataChannelState.Open)
+            {
+                throw new InvalidOperationException("DataChannel is not open");
+            }
+            if (count == 0)
+                return 0;
+            return WebRTC.Context.DataChannelSendBatch(GetSelfOrThrow(), messages, count);
+        }
+
         /// <summary>
         /// Closes the RTCDataChannel. Either peer is permitted to call this method to initiate closure of the channel.
         /// </summary>
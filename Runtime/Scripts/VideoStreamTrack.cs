@@ -435,7 +435,7 @@ namespace Unity.WebRTC
         {
             if (Texture == null)
                 return;
-            WebRTC.Context.UpdateRendererTexture(id, Texture);
+            WebRTC.Context.rendererBatch.Add(id, Texture);
         }
 
         ~UnityVideoRenderer()
@@ -807,6 +807,9 @@ namespace Unity.WebRTC
                         }
                     }
 
+                    // The texture updates of the renderers are issued before the batch flushes the command buffer.
+                    Context.rendererBatch.Submit();
+
                     batch.data.tracksCount = trackIndex;
                     if (trackIndex > 0)
                         batch.Submit();
@@ -1411,6 +1414,8 @@ namespace Unity.WebRTC
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
     internal delegate void DelegateNativeOnError(IntPtr ptr, RTCErrorType errorType, [MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 3)] byte[] message, int size);
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    internal delegate void DelegateNativeOnBufferedAmountLow(IntPtr ptr, ulong bufferedAmount);
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
     internal delegate void DelegateNativeMediaStreamOnAddTrack(IntPtr stream, IntPtr track);
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
     internal delegate void DelegateNativeMediaStreamOnRemoveTrack(IntPtr stream, IntPtr track);
@@ -1463,6 +1468,10 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextGetStatsList(IntPtr context, IntPtr report, out ulong length, ref IntPtr types);
         [DllImport(WebRTC.Lib)]
+        public static extern ulong ContextSerializeStatsReport(IntPtr context, IntPtr report, byte[] buffer, ulong capacity);
+        [DllImport(WebRTC.Lib)]
+        public static extern ulong ContextSerializeStatsReportFiltered(IntPtr context, IntPtr report, IntPtr previous, uint[] types, ulong typesLength, [MarshalAs(UnmanagedType.LPArray, ArraySubType = UnmanagedType.LPStr)] string[] members, ulong membersLength, byte[] buffer, ulong capacity);
+        [DllImport(WebRTC.Lib)]
         public static extern void ContextDeleteStatsReport(IntPtr context, IntPtr report);
         [DllImport(WebRTC.Lib)]
         public static extern void ContextAddRefPtr(IntPtr context, IntPtr ptr);
@@ -1645,6 +1654,8 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void DataChannelSendBinary(IntPtr ptr, [MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 2)] byte[] bytes, int size);
         [DllImport(WebRTC.Lib)]
+        public static extern int DataChannelSendBatch(IntPtr ctx, IntPtr ptr, RTCDataChannelSpan[] messages, int count);
+        [DllImport(WebRTC.Lib)]
         public static extern void DataChannelClose(IntPtr ptr);
         [DllImport(WebRTC.Lib)]
         public static extern void DataChannelRegisterOnMessage(IntPtr ctx, IntPtr ptr, DelegateNativeOnMessage callback);
@@ -1655,6 +1666,16 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void DataChannelRegisterOnError(IntPtr ctx, IntPtr ptr, DelegateNativeOnError callback);
         [DllImport(WebRTC.Lib)]
+        public static extern void DataChannelRegisterOnBufferedAmountLow(IntPtr ctx, IntPtr ptr, DelegateNativeOnBufferedAmountLow callback);
+        [DllImport(WebRTC.Lib)]
+        public static extern void DataChannelSetBufferedAmountLowThreshold(IntPtr ctx, IntPtr ptr, ulong threshold);
+        [DllImport(WebRTC.Lib)]
+        public static extern IntPtr DataChannelSetQueuedDelivery(IntPtr ctx, IntPtr ptr, [MarshalAs(UnmanagedType.U1)] bool enabled);
+        [DllImport(WebRTC.Lib)]
+        public static extern int DataChannelReceiveMessages(IntPtr queue, [Out] DataChannelMessageView[] views, int capacity);
+        [DllImport(WebRTC.Lib)]
+        public static extern void DataChannelReleaseMessages(IntPtr queue);
+        [DllImport(WebRTC.Lib)]
         public static extern IntPtr ContextCreateMediaStream(IntPtr ctx, [MarshalAs(UnmanagedType.LPStr, SizeConst = 256)] string label);
         [DllImport(WebRTC.Lib)]
         public static extern void ContextRegisterMediaStreamObserver(IntPtr ctx, IntPtr stream);
@@ -1672,6 +1693,10 @@ namespace Unity.WebRTC
         public static extern void AudioTrackSinkProcessAudio(
             IntPtr sink, float[] data, int length, int channels, int sampleRate);
         [DllImport(WebRTC.Lib)]
+        public static extern void AudioTrackSinkSetDriftCorrection(IntPtr sink, [MarshalAs(UnmanagedType.U1)] bool enabled);
+        [DllImport(WebRTC.Lib)]
+        public static extern void AudioTrackSinkGetStats(IntPtr sink, out ulong underruns, out ulong overruns, out ulong droppedFrames, out ulong insertedFrames, out int bufferedMs, out int targetMs);
+        [DllImport(WebRTC.Lib)]
         [return: MarshalAs(UnmanagedType.U1)]
         public static extern bool MediaStreamAddTrack(IntPtr stream, IntPtr track);
         [DllImport(WebRTC.Lib)]
@@ -1706,6 +1731,10 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void DeleteVideoRenderer(IntPtr context, IntPtr sink);
         [DllImport(WebRTC.Lib)]
+        public static extern int VideoRendererGetStats(IntPtr sink, out ulong framesReceived, out ulong framesRendered, out ulong framesOverwritten, [Out, MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 5)] ulong[] latencyHistogram, int bucketCount);
+        [DllImport(WebRTC.Lib)]
+        public static extern int VideoRendererGetLatencyBucketBounds([Out, MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 1)] long[] boundsMs, int count);
+        [DllImport(WebRTC.Lib)]
         public static extern void VideoTrackAddOrUpdateSink(IntPtr track, IntPtr sink);
         [DllImport(WebRTC.Lib)]
         public static extern void VideoTrackRemoveSink(IntPtr track, IntPtr sink);
@@ -1716,8 +1745,20 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern int GetBatchUpdateEventID();
         [DllImport(WebRTC.Lib)]
+        public static extern void SetGpuMemoryBufferPoolBudget(ulong maxBytes, uint maxInFlightFramesPerSource);
+        [DllImport(WebRTC.Lib)]
+        public static extern void SetGpuMemoryBufferPoolCpuReadbackOnDemand([MarshalAs(UnmanagedType.U1)] bool value);
+        [DllImport(WebRTC.Lib)]
+        public static extern void GetI420BufferPoolCounters(out ulong hitCount, out ulong missCount);
+        [DllImport(WebRTC.Lib)]
+        public static extern void SetRGBToI420ConversionThreadCount(uint threadCount);
+        [DllImport(WebRTC.Lib)]
         public static extern IntPtr GetUpdateTextureFunc(IntPtr context);
         [DllImport(WebRTC.Lib)]
+        public static extern IntPtr GetBatchRendererUpdateEventFunc(IntPtr context);
+        [DllImport(WebRTC.Lib)]
+        public static extern int GetBatchRendererUpdateEventID();
+        [DllImport(WebRTC.Lib)]
         public static extern void AudioSourceProcessLocalAudio(IntPtr source, IntPtr array, int sampleRate, int channels, int frames);
         [DllImport(WebRTC.Lib)]
         [return: MarshalAs(UnmanagedType.U1)]
@@ -1725,6 +1766,12 @@ namespace Unity.WebRTC
         [DllImport(WebRTC.Lib)]
         public static extern void VideoSourceSetSyncApplicationFramerate(IntPtr source, [MarshalAs(UnmanagedType.U1)] bool value);
         [DllImport(WebRTC.Lib)]
+        public static extern ulong VideoSourceGetDroppedFrameCount(IntPtr source);
+        [DllImport(WebRTC.Lib)]
+        public static extern void VideoSourceSetAbsoluteFramePacing(IntPtr source, [MarshalAs(UnmanagedType.U1)] bool value);
+        [DllImport(WebRTC.Lib)]
+        public static extern void VideoSourceGetFramePacingStats(IntPtr source, out ulong framesScheduled, out ulong framesCaptured, out ulong framesLate, out ulong framesSkipped, out long lastCaptureLatencyUs);
+        [DllImport(WebRTC.Lib)]
         public static extern IntPtr StatsGetJson(IntPtr stats);
         [DllImport(WebRTC.Lib)]
         public static extern IntPtr StatsGetId(IntPtr stats);
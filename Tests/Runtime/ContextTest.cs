@@ -116,5 +116,21 @@ namespace Unity.WebRTC.RuntimeTest
             var context = WebRTC.Context;
             context.DeleteStatsReport(IntPtr.Zero);
         }
+
+        [Test]
+        public void SerializeStatsReportIgnoreInvalidValue()
+        {
+            var context = WebRTC.Context;
+            Assert.That(context.SerializeStatsReport(IntPtr.Zero, new byte[64]), Is.EqualTo(0));
+        }
+
+        [Test]
+        public void SerializeFilteredStatsReportIgnoreInvalidValue()
+        {
+            var context = WebRTC.Context;
+            var types = new[] { RTCStatsType.OutboundRtp };
+            var members = new[] { "bytesSent", "framesEncoded" };
+            Assert.That(context.SerializeStatsReport(IntPtr.Zero, IntPtr.Zero, types, members, new byte[64]), Is.EqualTo(0));
+        }
     }
 }
@@ -1,5 +1,6 @@
 using System;
 using System.Collections;
+using System.Collections.Generic;
 using System.Diagnostics;
 using NUnit.Framework;
 using Unity.Collections;
@@ -28,6 +29,23 @@ namespace Unity.WebRTC.RuntimeTest
             peer.Close();
         }
 
+        [Test]
+        public void SetAndClearOnBufferedAmountLow()
+        {
+            var peer = new RTCPeerConnection();
+            var channel1 = peer.CreateDataChannel("test1");
+            Assert.That(channel1.OnBufferedAmountLow, Is.Null);
+
+            DelegateOnBufferedAmountLow onBufferedAmountLow = () => { };
+            channel1.OnBufferedAmountLow = onBufferedAmountLow;
+            Assert.That(channel1.OnBufferedAmountLow, Is.EqualTo(onBufferedAmountLow));
+            channel1.OnBufferedAmountLow = null;
+            Assert.That(channel1.OnBufferedAmountLow, Is.Null);
+
+            channel1.Close();
+            peer.Close();
+        }
+
         [Test]
         public void CreateDataChannelWithOption()
         {
@@ -268,6 +286,156 @@ namespace Unity.WebRTC.RuntimeTest
             Object.DestroyImmediate(test.gameObject);
         }
 
+        [UnityTest]
+        [Timeout(5000)]
+        [UnityPlatform(exclude = new[] { RuntimePlatform.IPhonePlayer })]
+        public IEnumerator SendAndReceiveQueuedMessages()
+        {
+            var test = new MonoBehaviourTest<SignalingPeers>();
+            RTCDataChannel channel1 = test.component.CreateDataChannel(0, "test");
+            Assert.That(channel1, Is.Not.Null);
+            yield return test;
+
+            var op1 = new WaitUntilWithTimeout(() => test.component.GetDataChannelList(1).Count > 0, 5000);
+            yield return op1;
+            RTCDataChannel channel2 = test.component.GetDataChannelList(1)[0];
+            Assert.That(channel2, Is.Not.Null);
+
+            var received = new List<byte[]>();
+            channel2.OnMessage = bytes => { received.Add(bytes); };
+            channel2.QueuedDelivery = true;
+            Assert.That(channel2.QueuedDelivery, Is.True);
+
+            byte[][] messages = { new byte[] { 1 }, new byte[] { 2, 3 }, new byte[] { 4, 5, 6 } };
+            foreach (var message in messages)
+                channel1.Send(message);
+
+            // The messages are only passed to OnMessage when they are dispatched.
+            var op2 = new WaitUntilWithTimeout(() =>
+            {
+                channel2.DispatchQueuedMessages();
+                return received.Count == messages.Length;
+            }, 5000);
+            yield return op2;
+            Assert.That(op2.IsCompleted, Is.True);
+            Assert.That(received, Is.EqualTo(messages));
+
+            int length = 0;
+            channel1.Send(new byte[] { 7, 8 });
+            var op3 = new WaitUntilWithTimeout(() =>
+            {
+                channel2.DispatchQueuedMessages((data, size) => { length += size; });
+                return length > 0;
+            }, 5000);
+            yield return op3;
+            Assert.That(op3.IsCompleted, Is.True);
+            Assert.That(length, Is.EqualTo(2));
+            Assert.That(received.Count, Is.EqualTo(messages.Length));
+
+            test.component.Dispose();
+            Object.DestroyImmediate(test.gameObject);
+        }
+
+        [UnityTest]
+        [Timeout(5000)]
+        [UnityPlatform(exclude = new[] { RuntimePlatform.IPhonePlayer })]
+        public IEnumerator DisposeWhileDispatchingQueuedMessages()
+        {
+            var test = new MonoBehaviourTest<SignalingPeers>();
+            RTCDataChannel channel1 = test.component.CreateDataChannel(0, "test");
+            Assert.That(channel1, Is.Not.Null);
+            yield return test;
+
+            var op1 = new WaitUntilWithTimeout(() => test.component.GetDataChannelList(1).Count > 0, 5000);
+            yield return op1;
+            RTCDataChannel channel2 = test.component.GetDataChannelList(1)[0];
+            Assert.That(channel2, Is.Not.Null);
+            channel2.QueuedDelivery = true;
+
+            // Another thread dispatches the messages until the channel is disposed on the main thread.
+            int length = 0;
+            Exception error = null;
+            var dispatcher = new System.Threading.Thread(() =>
+            {
+                try
+                {
+                    while (true)
+                        channel2.DispatchQueuedMessages((data, size) => System.Threading.Interlocked.Add(ref length, size));
+                }
+                catch (ObjectDisposedException)
+                {
+                }
+                catch (Exception e)
+                {
+                    error = e;
+                }
+            });
+            dispatcher.Start();
+
+            var message = new byte[] { 1, 2, 3 };
+            var op2 = new WaitUntilWithTimeout(() =>
+            {
+                channel1.Send(message);
+                return System.Threading.Volatile.Read(ref length) > 0;
+            }, 5000);
+            yield return op2;
+            Assert.That(op2.IsCompleted, Is.True);
+
+            for (int i = 0; i < 100; i++)
+                channel1.Send(message);
+            channel2.Dispose();
+            Assert.That(dispatcher.Join(5000), Is.True);
+            Assert.That(error, Is.Null);
+
+            test.component.Dispose();
+            Object.DestroyImmediate(test.gameObject);
+        }
+
+        [UnityTest]
+        [Timeout(5000)]
+        [UnityPlatform(exclude = new[] { RuntimePlatform.IPhonePlayer })]
+        public IEnumerator SendBatchAndReceiveMessages()
+        {
+            var test = new MonoBehaviourTest<SignalingPeers>();
+            RTCDataChannel channel1 = test.component.CreateDataChannel(0, "test");
+            Assert.That(channel1, Is.Not.Null);
+            var spans = new RTCDataChannelSpan[3];
+            Assert.That(() => channel1.SendBatch(spans, 3), Throws.TypeOf<InvalidOperationException>());
+            Assert.That(() => channel1.SendBatch(spans, 4), Throws.TypeOf<ArgumentOutOfRangeException>());
+            yield return test;
+
+            var op1 = new WaitUntilWithTimeout(() => test.component.GetDataChannelList(1).Count > 0, 5000);
+            yield return op1;
+            RTCDataChannel channel2 = test.component.GetDataChannelList(1)[0];
+            Assert.That(channel2, Is.Not.Null);
+
+            var received = new List<byte[]>();
+            channel2.OnMessage = bytes => { received.Add(bytes); };
+
+            channel1.BufferedAmountLowThreshold = 1024;
+            Assert.That(channel1.BufferedAmountLowThreshold, Is.EqualTo(1024));
+
+            byte[][] messages = { new byte[] { 1 }, new byte[] { 2, 3 }, new byte[] { 4, 5, 6 } };
+            var buffer = new NativeArray<byte>(new byte[] { 1, 2, 3, 4, 5, 6 }, Allocator.Temp);
+            unsafe
+            {
+                var ptr = new IntPtr(buffer.GetUnsafeReadOnlyPtr());
+                spans[0] = new RTCDataChannelSpan(ptr, 1);
+                spans[1] = new RTCDataChannelSpan(ptr + 1, 2);
+                spans[2] = new RTCDataChannelSpan(ptr + 3, 3);
+            }
+            Assert.That(channel1.SendBatch(spans, spans.Length), Is.EqualTo(spans.Length));
+            buffer.Dispose();
+
+            var op2 = new WaitUntilWithTimeout(() => received.Count == messages.Length, 5000);
+            yield return op2;
+            Assert.That(op2.IsCompleted, Is.True);
+            Assert.That(received, Is.EqualTo(messages));
+
+            test.component.Dispose();
+            Object.DestroyImmediate(test.gameObject);
+        }
+
         [UnityTest]
         [Timeout(5000)]
         [UnityPlatform(exclude = new[] { RuntimePlatform.IPhonePlayer })]
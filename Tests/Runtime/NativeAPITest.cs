@@ -389,6 +389,14 @@ namespace Unity.WebRTC.RuntimeTest
             NativeMethods.GetUpdateTextureFunc(IntPtr.Zero);
         }
 
+        [Test]
+        public void CallGetBatchRendererUpdateEventFunc()
+        {
+            var callback = NativeMethods.GetBatchRendererUpdateEventFunc(context);
+            Assert.AreNotEqual(callback, IntPtr.Zero);
+            NativeMethods.GetBatchRendererUpdateEventFunc(IntPtr.Zero);
+        }
+
         [UnityTest, LongRunning]
         [ConditionalIgnoreMultiple(ConditionalIgnore.UnsupportedPlatformVideoDecoder,
             "VideoUpdateMethods.UpdateRendererTexture is not supported on Direct3D12.")]